@@ -14,11 +14,35 @@
  *           - alcd_write      : Low-level function to send command/data bytes in 4-bit mode
  *           - alcd_putc       : Print single character at current cursor position with auto-wrap
  *           - alcd_puts       : Print null-terminated string starting at current cursor position
+ *           - alcd_putn       : Print pre-encoded ROM codes (C++: alcd::rom() compile-time encoder)
  *           - alcd_gotoxy     : Position cursor at specific row (0-1) and column (0-15)
  *           - alcd_clear      : Clear entire display content and reset cursor to home (0,0)
  *           - alcd_display    : Configure display ON/OFF, cursor visibility, and blink state
  *           - alcd_customChar : Create custom 5x8 pixel character in CGRAM (addresses 0-7)
  *           - alcd_backLight  : Control LCD backlight ON/OFF (if backlight pin defined)
+ *           - alcd_snapshot   : Copy a consistent snapshot of the controller mirror (__alcd_vlcd)
+ *           - alcd_fbPutc     : Write character into the framebuffer (alcd_fbGotoxy/fbPuts/fbClear alike)
+ *           - alcd_flush      : Send only the framebuffer cells that differ from the LCD
+ *           - alcd_ctxPuts    : Print into a clipped screen region with its own cursor (alcd_ctxInit/ctxGotoxy alike)
+ *           - alcd_fbPriority : Mark cells urgent so they preempt large transfers (alcd_fbSet from ISRs)
+ *           - alcd_panelVisible: Hold updates while panel is closed or display off, send net diff later (optional)
+ *           - alcd_serialTxDone: Transfer complete hook of the I2C serial-controller backend (optional)
+ *           - alcd_fbGlyph    : Queue a CGRAM glyph for the next alcd_flush(), latest pattern wins (optional)
+ *           - alcd_historyTask: Program flush deltas of the black-box display history into flash (optional)
+ *           - alcd_flipMode   : Double-buffer the framebuffer in off-screen DDRAM, tear-free page flips (optional)
+ *           - alcd_gfxFlush   : Upload dirty columns of the WS0010 graphic-mode pixel framebuffer (optional)
+ *           - alcd_clockTask  : Redraw RTC driven clock widget, changed digits only (optional)
+ *           - alcd_task       : Flush at an adaptive rate driven by activity and CPU load (optional)
+ *           - alcd_modbusTask : Serve Modbus RTU register access to framebuffer and CGRAM (optional)
+ *           - alcd_canFrame   : Decode CAN display frames into the framebuffer (optional)
+ *           - alcd_dump       : Render visible display as ASCII art through the CGROM font (optional)
+ *           - alcd_scrollStep : Pixel-smooth ticker through CGRAM tiles, changed rows only (optional)
+ *           - alcd_statsReset : Reset bus/timing counters in __alcd_stats (optional)
+ *           - alcd_tag        : Attribute following bus costs to a screen or widget ID (optional)
+ *           - alcd_energyTask : Estimate display power and apply the power budget policy (optional)
+ *           - alcd_timingReport: Verify EN pulse and cycle times measured by timer input capture (optional)
+ *           - alcd_poolAlloc  : O(1) fixed-block allocation from the static arena (optional)
+ *           - __alcd_present  : Display detected at init, null transport when missing (optional)
  * 
  * @note     Hardware Requirements:
  *           - 6 GPIO pins for LCD control (RS, EN, DB4-DB7)
@@ -41,7 +65,6 @@
 
 #include "aKaReZa.h"
 
-
 /* ============================================================================
  *                    CRITICAL DEPENDENCY CHECK
  * ============================================================================
@@ -60,6 +83,47 @@
     #warning "============================================================"
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ============================================================================
+ *                         OPTIONAL FEATURES
+ * ============================================================================
+ *  Optional modules are compiled only when their switch is defined before
+ *  this header is included, e.g. in the "USER CODE BEGIN Private defines"
+ *  section of main.h:
+ *
+ *  #define __alcd_Render_Enable       CGROM font renderer: alcd_renderGlyph(), alcd_dump(), alcd_renderHash()
+ *  #define __alcd_CGROM_A02           Render with the A02 (European) ROM instead of A00 (Japanese)
+ *  #define __alcd_Scroll_Enable       Pixel-smooth ticker through CGRAM tiles: alcd_scrollStart(), alcd_scrollStep()
+ *  #define __alcd_Stats_Enable        Bus and timing counters in __alcd_stats, alcd_statsReset()
+ *  #define __alcd_Energy_Enable       Energy estimate and power budget policy (needs __alcd_Stats_Enable)
+ *  #define __alcd_Profile_Enable      Per screen/widget cost attribution: alcd_tag(), alcd_profileReport()
+ *                                     (needs __alcd_Stats_Enable)
+ *  #define __alcd_Timing_Enable       EN timing self-test from timer input capture: alcd_timingEdge(), alcd_timingReport()
+ *  #define __alcd_Arena_Enable        Static arena with fixed-block pools: alcd_poolCreate(), alcd_poolAlloc(), alcd_arenaReport()
+ *  #define __alcd_Clock_Enable        RTC driven clock/date widget: alcd_clockInit(), alcd_clockTick(), alcd_clockTask()
+ *                                     (big HH:MM digits with alcd_clockBig())
+ *  #define __alcd_Governor_Enable     Adaptive refresh rate: alcd_task(), alcd_activity(), alcd_idleEnter()/Exit()
+ *  #define __alcd_Modbus_Enable       Modbus RTU slave exposing framebuffer/CGRAM as holding registers
+ *                                     (also define __alcd_Modbus_UART, e.g. huart1)
+ *  #define __alcd_CAN_Enable          CAN display slave decoder and master-side diff encoder
+ *  #define __alcd_Headless_Enable     Detect a missing display at init and skip all bus traffic
+ *                                     (needs __alcd_Strap_GPIO_Port/_Pin or __alcd_RW_GPIO_Port/_Pin)
+ *  #define __alcd_Headless_NoShadow   Headless: do not maintain mirror and framebuffer either
+ *  #define __alcd_Lazy_Enable         Hold updates in the framebuffer while the display is off or the panel closed
+ *  #define __alcd_DarkPanel           With __alcd_Lazy_Enable and the governor: slow refresh while backlight is off
+ *  #define __alcd_Serial_Enable       I2C serial controller (ST7032, AIP31068, US2066) instead of the GPIO bus
+ *                                     (select __alcd_Serial_Controller, define __alcd_Serial_I2C, e.g. hi2c1)
+ *  #define __alcd_History_Enable      Black-box display history in a flash ring: alcd_historyTask(), alcd_historyDump()
+ *  #define __alcd_Queue_Enable        Coalescing update queue: pending bit per cell, alcd_fbGlyph(), alcd_queueDepth()
+ *  #define __alcd_Flip_Enable         Tear-free page flip through off-screen DDRAM columns: alcd_flipMode()
+ *  #define __alcd_BusConfig_Enable    Driver configures its own pins and switches bus direction with precomputed CRL/CRH images
+ *  #define __alcd_Graphic_Enable      WS0010/US2066 OLED graphic mode with pixel framebuffer: alcd_gfxMode(), alcd_gfxFlush()
+ * ============================================================================ */
+
 
 /* ============================================================================
  *                         COMMAND/DATA MODE SELECTION
@@ -82,6 +146,9 @@
 #define __alcd_delay_CMD      50             /**< Standard command execution time in microseconds */
 #define __alcd_delay_modeSet  5000           /**< Mode setting and clear command time in microseconds */
 #define __alcd_delay_powerON  50000          /**< Power-on stabilization time in microseconds (50ms) */
+#define __alcd_byteTime       (2 * __alcd_delay_CMD)  /**< Busy-wait time per byte in microseconds (two EN strobes per byte) */
+#define __alcd_refreshTime    (__alcd_byteTime * (__alcd_max_y * (__alcd_max_x + 1)))  /**< Full screen rewrite time in microseconds (one address command per row) */
+#define __alcd_clearTime      (__alcd_byteTime + __alcd_delay_modeSet)  /**< Clear Display / Return Home including the wait alcd_clear() applies */
 
 
 /* ============================================================================
@@ -137,6 +204,798 @@
 #define __alcd_CGRAM_Start   0x40            /**< CGRAM start address for custom character generation (8 characters, 0-7) */
 
 
+/* ============================================================================
+ *                         VIRTUAL LCD (CONTROLLER MIRROR)
+ * ============================================================================
+ *  Every byte passed to alcd_write() is also decoded into __alcd_vlcd, a RAM
+ *  copy of the controller state (DDRAM, CGRAM, address counter, modes, shift).
+ *  The layout below is fixed and versioned so that external viewers (debugger
+ *  live watch, SWD memory readers, test rigs) can attach to it directly by
+ *  symbol or by scanning RAM for __alcd_vlcd_Magic, without any help from the
+ *  running firmware.
+ *
+ *  Consistency: "sequence" is incremented before and after every update, so
+ *  it is odd while the mirror is being modified. A reader takes a snapshot
+ *  as follows:
+ *      1. read sequence (retry while odd)
+ *      2. copy the fields of interest
+ *      3. read sequence again - if it changed, discard the copy and retry
+ *  The writer puts a memory barrier after the first and before the second
+ *  increment, so all mirror stores fall inside the odd window. A reader in
+ *  the firmware must not run at a higher priority than alcd_write(): it
+ *  would spin on an odd sequence that can never become even.
+ *
+ *  Offset  Size  Field
+ *  0x00    4     magic           __alcd_vlcd_Magic ("aLCD" in memory order)
+ *  0x04    2     version         __alcd_vlcd_Version
+ *  0x06    2     size            sizeof(alcd_vlcd_t)
+ *  0x08    4     sequence        Update counter (odd = update in progress)
+ *  0x0C    1     address         Address counter (DDRAM 0x00-0x67 or CGRAM 0x00-0x3F)
+ *  0x0D    1     cgramSelect     1 if the address counter points into CGRAM
+ *  0x0E    1     entryMode       Last entry mode set command (0x04-0x07)
+ *  0x0F    1     displayControl  Last display control command (0x08-0x0F)
+ *  0x10    1     functionSet     Last function set command (0x20-0x3F)
+ *  0x11    1     shift           Display shift: DDRAM column shown at the left edge (0-39)
+ *  0x12    2     reserved        Always 0
+ *  0x14    80    ddram[2][40]    DDRAM line 0 (0x00-0x27) and line 1 (0x40-0x67)
+ *  0x64    64    cgram[64]       CGRAM, 8 characters x 8 rows
+ * ============================================================================ */
+#define __alcd_vlcd_Magic     0x44434C61     /**< "aLCD" as stored in little-endian memory */
+#define __alcd_vlcd_Version   1              /**< Layout version, incremented on incompatible changes */
+#define __alcd_DDRAM_Lines    2              /**< Number of DDRAM lines in 2-line mode */
+#define __alcd_DDRAM_Columns  40             /**< DDRAM columns per line (0x00-0x27 / 0x40-0x67) */
+#define __alcd_CGRAM_Size     64             /**< CGRAM size in bytes (8 characters x 8 rows) */
+
+typedef struct
+{
+    uint32_t magic;                                              /**< Layout signature (__alcd_vlcd_Magic) */
+    uint16_t version;                                            /**< Layout version (__alcd_vlcd_Version) */
+    uint16_t size;                                               /**< Structure size in bytes */
+    volatile uint32_t sequence;                                  /**< Update counter, odd while an update is in progress */
+    uint8_t  address;                                            /**< Controller address counter */
+    uint8_t  cgramSelect;                                        /**< 1 if the address counter points into CGRAM */
+    uint8_t  entryMode;                                          /**< Last entry mode set command */
+    uint8_t  displayControl;                                     /**< Last display control command */
+    uint8_t  functionSet;                                        /**< Last function set command */
+    uint8_t  shift;                                              /**< Display shift (DDRAM column at left edge) */
+    uint8_t  reserved[2];                                        /**< Padding, always 0 */
+    uint8_t  ddram[__alcd_DDRAM_Lines][__alcd_DDRAM_Columns];    /**< DDRAM contents per line */
+    uint8_t  cgram[__alcd_CGRAM_Size];                           /**< CGRAM contents */
+} alcd_vlcd_t;
+
+extern alcd_vlcd_t __alcd_vlcd;              /**< Controller mirror, see layout above */
+
+
+/* ============================================================================
+ *                         FRAMEBUFFER
+ * ============================================================================
+ *  __alcd_fb holds the intended content of every visible cell. alcd_fbPutc()
+ *  and friends only write RAM; alcd_flush() compares the framebuffer with
+ *  the controller mirror and sends just the cells that differ, skipping the
+ *  set-address command while the changed cells are contiguous.
+ *  The direct API (alcd_putc, alcd_clear) writes through to the framebuffer,
+ *  so both APIs can be mixed freely.
+ * ============================================================================ */
+extern uint8_t __alcd_fb[__alcd_max_y][__alcd_max_x];  /**< Shadow framebuffer (visible cells) */
+
+
+/* ============================================================================
+ *                         PRINT CONTEXTS
+ * ============================================================================
+ *  A print context is a clip rectangle with its own cursor, so modules that
+ *  own different areas of the screen (status corner, value column, message
+ *  line) can print in any interleaving without sharing the global cursor.
+ *  Context output goes into the framebuffer like alcd_fbPutc(); the next
+ *  alcd_flush() merges all regions and only addresses where changed cells
+ *  are not contiguous, so switching contexts costs no bus traffic.
+ *  With wrap enabled the cursor continues on the next region row and
+ *  returns to the region origin after the last row; without wrap, text
+ *  past the right edge is dropped until the next alcd_ctxGotoxy().
+ * ============================================================================ */
+typedef struct
+{
+    uint8_t x;                               /**< Region origin column */
+    uint8_t y;                               /**< Region origin row */
+    uint8_t width;                           /**< Region width in cells */
+    uint8_t height;                          /**< Region height in rows */
+    uint8_t col;                             /**< Cursor column, relative to the region */
+    uint8_t row;                             /**< Cursor row, relative to the region */
+    bool wrap;                               /**< true=wrap to the next region row, false=clip at the right edge */
+} alcd_ctx_t;
+
+
+/* ============================================================================
+ *                         PRIORITY LANES
+ * ============================================================================
+ *  Cells can be marked urgent with alcd_fbPriority(). alcd_flush() sends
+ *  urgent cells first and, while working through normal cells or a CGRAM
+ *  reload (alcd_customChar), checks between bytes whether an urgent cell
+ *  was written meanwhile (typically from an interrupt via alcd_fbSet()).
+ *  If so, the urgent cells are serviced before the transfer resumes.
+ *  Worst-case latency of an urgent cell is therefore one byte time plus
+ *  two bytes per pending urgent cell, independent of the transfer size.
+ * ============================================================================ */
+#if __alcd_max_x > 32
+    #error "Priority lanes support at most 32 columns (__alcd_max_x)"
+#endif
+extern uint32_t __alcd_fbUrgent[__alcd_max_y];        /**< Urgent cell mask per row (bit n = column n) */
+extern volatile bool __alcd_urgentPending;            /**< An urgent cell was written since it was last flushed */
+
+
+/* ============================================================================
+ *                         UPDATE QUEUE
+ * ============================================================================
+ *  With __alcd_Queue_Enable, the framebuffer doubles as a coalescing update
+ *  queue keyed by cell position and CGRAM slot. Every framebuffer write
+ *  sets the pending bit of its cell in __alcd_queuePending, and
+ *  alcd_fbGlyph() stores a glyph with a pending bit per slot. A newer write
+ *  to the same cell or slot replaces the pending value instead of adding an
+ *  entry, so the queue is bounded by the screen size (one bit per cell,
+ *  eight glyph patterns) however fast producers write, and alcd_flush()
+ *  visits only pending entries and always sends the newest content.
+ *  Pending bits are taken with interrupts masked for a few cycles; a value
+ *  written while its cell is being sent stays pending for the next flush.
+ *  In flip mode the flush still scans every cell, because the hidden page
+ *  lags two frames behind.
+ *  Application code must write cells through alcd_fbSet() and friends;
+ *  a direct store into __alcd_fb is not queued.
+ * ============================================================================ */
+#define __alcd_queueRowMask     ((__alcd_max_x == 32) ? 0xFFFFFFFFUL : ((1UL << __alcd_max_x) - 1))  /**< All cells of a row */
+
+#ifdef __alcd_Queue_Enable
+    extern volatile uint32_t __alcd_queuePending[__alcd_max_y];  /**< Pending cell mask per row (bit n = column n) */
+    extern volatile uint8_t __alcd_queueGlyphPending;  /**< Pending CGRAM slot mask (bit n = slot n) */
+#endif
+
+
+/* ============================================================================
+ *                         REFRESH GOVERNOR
+ * ============================================================================
+ *  With __alcd_Governor_Enable, alcd_task() flushes the framebuffer at a
+ *  dynamically chosen period: it drops to __alcd_Gov_MinPeriod on user
+ *  activity (alcd_activity) and halves while values keep changing; it
+ *  doubles up to __alcd_Gov_MaxPeriod while the screen is static or the
+ *  CPU load (measured with the DWT cycle counter between alcd_idleEnter()
+ *  and alcd_idleExit()) is above __alcd_Gov_BusyLoad.
+ *  Urgent cells (alcd_fbPriority) are flushed on every call regardless.
+ *  All values can be overridden before this header is included.
+ * ============================================================================ */
+#ifndef __alcd_Gov_MinPeriod
+    #define __alcd_Gov_MinPeriod  20         /**< Fastest refresh period in ms (50 Hz) */
+#endif
+#ifndef __alcd_Gov_MaxPeriod
+    #define __alcd_Gov_MaxPeriod  500        /**< Slowest refresh period in ms (2 Hz floor) */
+#endif
+#ifndef __alcd_Gov_BusyLoad
+    #define __alcd_Gov_BusyLoad   80         /**< CPU load in percent above which the rate is lowered */
+#endif
+#ifndef __alcd_Gov_Window
+    #define __alcd_Gov_Window     1000       /**< CPU load measurement window in ms */
+#endif
+
+
+/* ============================================================================
+ *                         DISPLAY HISTORY RECORDER
+ * ============================================================================
+ *  With __alcd_History_Enable, every alcd_flush() appends what changed on
+ *  the screen since the previous record to a ring of __alcd_History_Pages
+ *  flash pages, so the screens an operator saw before a fault can be
+ *  replayed afterwards. Records are built in RAM (__alcd_histQueue); the
+ *  flush never touches flash. alcd_historyTask(), called from the main
+ *  loop, programs at most __alcd_History_Burst half-words per call and
+ *  erases the next page (the oldest one) when the ring reaches it.
+ *  Flash cannot be read while it is programmed or erased, so on the
+ *  single-bank F103 the CPU, interrupts included, stalls for each burst
+ *  and for the 20-40 ms page erase.
+ *
+ *  Record format (even length, little endian, 0xFF = erased):
+ *      0     length     Record size in bytes
+ *      1     type       'K' key frame, 'B' key frame after reset, 'D' delta
+ *      2-5   time       alcd_historyTime() (HAL tick, override for RTC)
+ *      key:   6-9 sequence number, 10.. all cells row by row
+ *      delta: runs of [position (row * __alcd_max_x + column)][count][cells],
+ *             a 0xFF pad byte makes the length even
+ *  Every page starts with a key frame, so replay can start at any page.
+ *  A key frame is also written after reset and after a record was dropped
+ *  because the queue was full (counted in __alcd_history.dropped).
+ *  A failed page erase or half-word program is counted in
+ *  __alcd_history.flashErrors and stops recording until the next reset,
+ *  so a worn or locked page is never written past.
+ *  alcd_historyDump() prints all records oldest first as "H <hex>" lines;
+ *  Tools/alcd_history.py turns such a dump back into frames.
+ *  __alcd_history.cycles/cyclesMax hold the DWT cycles spent recording in
+ *  the flush; the work is one pass over the cells, bounded by the screen
+ *  size and independent of the flash state.
+ *  Direct API output (alcd_putc) is recorded with the next alcd_flush().
+ * ============================================================================ */
+#ifndef __alcd_History_Start
+    #define __alcd_History_Start    0x0800F000  /**< First flash page of the ring (last 4 KB of a 64 KB F103C8) */
+#endif
+#ifndef __alcd_History_Pages
+    #define __alcd_History_Pages    4        /**< Flash pages in the ring */
+#endif
+#ifndef __alcd_History_PageSize
+    #define __alcd_History_PageSize FLASH_PAGE_SIZE  /**< Flash page size (1 KB on medium density devices) */
+#endif
+#ifndef __alcd_History_Queue
+    #define __alcd_History_Queue    256      /**< RAM queue for records not yet programmed (power of two) */
+#endif
+#ifndef __alcd_History_Burst
+    #define __alcd_History_Burst    16       /**< Half-words programmed per alcd_historyTask() call */
+#endif
+#define __alcd_History_Key      'K'          /**< Record type: key frame */
+#define __alcd_History_Boot     'B'          /**< Record type: key frame after reset */
+#define __alcd_History_Delta    'D'          /**< Record type: changed cell runs */
+#define __alcd_History_KeySize  ((10 + __alcd_max_x * __alcd_max_y + 1) & ~1)  /**< Key frame record size */
+
+typedef struct
+{
+    uint32_t records;                        /**< Records queued */
+    uint32_t keys;                           /**< Key frames among them */
+    uint32_t dropped;                        /**< Records lost because the queue was full */
+    uint32_t flashErrors;                    /**< Failed erases/programs; recording stops at the first */
+    uint32_t bytes;                          /**< Bytes queued */
+    uint32_t cycles;                         /**< CPU cycles of the last recording in alcd_flush() */
+    uint32_t cyclesMax;                      /**< Longest recording in CPU cycles */
+} alcd_history_t;
+
+#ifdef __alcd_History_Enable
+    #if (__alcd_History_Queue & (__alcd_History_Queue - 1)) != 0 || __alcd_History_Queue < 2 * __alcd_History_KeySize
+        #error "__alcd_History_Queue must be a power of two holding at least two key frames"
+    #endif
+    #if __alcd_max_x * __alcd_max_y > 255 - 10
+        #error "Display history records hold at most 245 cells"
+    #endif
+    extern alcd_history_t __alcd_history;    /**< Recorder statistics */
+#endif
+
+
+/* ============================================================================
+ *                         SERIAL CONTROLLER BACKEND
+ * ============================================================================
+ *  With __alcd_Serial_Enable, alcd_write() talks to a controller with a
+ *  native I2C interface instead of bit-banging RS/EN/DB pins. Every byte is
+ *  preceded by a control byte: bit 7 Co (1 = another control byte follows
+ *  after this data byte), bit 6 RS (0 = command, 1 = data). Writes are
+ *  collected in __alcd_serialBuffer; outside a burst each alcd_write() is
+ *  one transaction, while alcd_flush() and alcd_customChar() send all their
+ *  bytes as a single DMA transaction. The final run of bytes of the same
+ *  kind is sent after one control byte with Co=0, so a run of changed cells
+ *  costs one bus byte per cell.
+ *  Bytes of the final run arrive one I2C byte time apart; choose the bus
+ *  clock so that this exceeds the controller's execution time (ST7032 and
+ *  AIP31068: 100 kHz, US2066: up to 400 kHz).
+ *  The transfer complete callback must call alcd_serialTxDone(), e.g.
+ *      void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) { alcd_serialTxDone(); }
+ *  (also from HAL_I2C_ErrorCallback). A new transaction waits for the
+ *  previous one at most __alcd_Serial_Timeout ms, then aborts it with
+ *  alcd_serialAbort(). If the abort fails the new transaction is dropped
+ *  and counted in __alcd_serialDropped, since the DMA may still read the
+ *  buffer; the cells it carried are stale until they change again.
+ *  Without __alcd_Serial_I2C, provide alcd_serialTransmit() yourself
+ *  (other I2C driver, bit-banged I2C or a test model) and optionally
+ *  alcd_serialAbort(); the weak default cannot abort.
+ * ============================================================================ */
+#define __alcd_Ctrl_ST7032      1            /**< Sitronix ST7032(i), internal booster and contrast */
+#define __alcd_Ctrl_AIP31068    2            /**< AiP31068L, HD44780 compatible with I2C (Grove RGB LCD) */
+#define __alcd_Ctrl_US2066      3            /**< WiseChip US2066 / SSD1311 OLED character controller */
+
+#ifndef __alcd_Serial_Controller
+    #define __alcd_Serial_Controller  __alcd_Ctrl_ST7032  /**< Fitted serial controller */
+#endif
+#ifndef __alcd_Serial_Address
+    #if __alcd_Serial_Controller == __alcd_Ctrl_US2066
+        #define __alcd_Serial_Address 0x78   /**< I2C address, HAL format (0x3C << 1, SA0=0) */
+    #else
+        #define __alcd_Serial_Address 0x7C   /**< I2C address, HAL format (0x3E << 1) */
+    #endif
+#endif
+#ifndef __alcd_Serial_BufferSize
+    #define __alcd_Serial_BufferSize  160    /**< Transaction buffer, a full 16x2 flush needs 2 bytes per cell plus addresses */
+#endif
+#ifndef __alcd_Serial_Timeout
+    #define __alcd_Serial_Timeout     10     /**< Maximum wait for the previous transaction in ms */
+#endif
+#ifndef __alcd_Serial_Contrast
+    #define __alcd_Serial_Contrast    0x28   /**< ST7032: contrast 0-63, US2066: contrast 0-255 */
+#endif
+#ifndef __alcd_Serial_Booster
+    #define __alcd_Serial_Booster     1      /**< ST7032: 1 = internal booster on (3.3V supply), 0 = off (5V) */
+#endif
+#ifndef __alcd_Serial_Regulator
+    #define __alcd_Serial_Regulator   0      /**< US2066: 1 = internal VDD regulator on (5V I/O), 0 = off */
+#endif
+#define __alcd_Serial_Co        0x80         /**< Control byte: another control byte follows */
+#define __alcd_Serial_RS        0x40         /**< Control byte: data (RS=1) */
+
+#ifdef __alcd_Serial_Enable
+    #if defined(__alcd_BusConfig_Enable) || (defined(__alcd_Headless_Enable) && defined(__alcd_RW_GPIO_Port))
+        #error "__alcd_Serial_Enable has no parallel bus: __alcd_BusConfig_Enable and the busy flag probe are not available"
+    #endif
+    extern uint8_t __alcd_serialBuffer[__alcd_Serial_BufferSize];  /**< Transaction being built or sent */
+    extern uint32_t __alcd_serialDropped;                          /**< Transactions dropped because the bus stayed busy */
+#endif
+
+
+/* ============================================================================
+ *                         BUS PIN CONFIGURATION
+ * ============================================================================
+ *  With __alcd_BusConfig_Enable, alcd_init() configures RS, EN and the data
+ *  pins itself (port clock, push-pull output at __alcd_Bus_Speed) and keeps
+ *  CRL/CRH register images of every involved port for both bus directions.
+ *  Switching the data pins between output and input (pull-down, for busy
+ *  flag reads) is then one CRL and one CRH store per port instead of a
+ *  HAL_GPIO_Init() call per pin. The images include the other pins of the
+ *  same ports as configured before alcd_init(), so configure those first.
+ * ============================================================================ */
+#ifndef __alcd_Bus_Speed
+    #define __alcd_Bus_Speed    GPIO_SPEED_FREQ_MEDIUM  /**< Output speed of the bus pins (MODE bits: LOW 2MHz, MEDIUM 10MHz, HIGH 50MHz) */
+#endif
+#define __alcd_Bus_CnfInput     0x08         /**< CNF/MODE nibble: input with pull-up/pull-down */
+
+
+/* ============================================================================
+ *                         VISIBILITY-AWARE REFRESH
+ * ============================================================================
+ *  With __alcd_Lazy_Enable, nothing is transmitted while the display is
+ *  switched off with alcd_display(false, ...) or the panel is reported
+ *  closed with alcd_panelVisible(false). alcd_putc()/alcd_puts() and the
+ *  framebuffer API only update the framebuffer; when the display becomes
+ *  visible again the net difference is sent in one flush (before the
+ *  display is switched on, so no intermediate content is seen).
+ *  For panels that cannot be read without backlight, __alcd_DarkPanel makes
+ *  the governor refresh no faster than __alcd_Gov_DarkPeriod while the
+ *  backlight is off.
+ * ============================================================================ */
+#ifndef __alcd_Gov_DarkPeriod
+    #define __alcd_Gov_DarkPeriod 2000       /**< Refresh period in ms while a dark panel has no backlight */
+#endif
+
+#ifdef __alcd_Lazy_Enable
+    #if defined(__alcd_DarkPanel) && !defined(__alcd_BL_GPIO_Port)
+        #error "__alcd_DarkPanel requires the backlight pin (__alcd_BL_GPIO_Port)"
+    #endif
+    extern bool __alcd_displayOn;            /**< Display switched on by alcd_display() */
+    extern bool __alcd_panelOpen;            /**< Panel reported visible by alcd_panelVisible() */
+    #define __alcd_isVisible()  (__alcd_displayOn && __alcd_panelOpen && __alcd_textActive())  /**< Text updates reach the display */
+#else
+    #define __alcd_isVisible()  (__alcd_textActive())                   /**< Transmit unless in graphic mode */
+#endif
+
+
+/* ============================================================================
+ *                         PAGE FLIP
+ * ============================================================================
+ *  Each DDRAM line has 40 columns, of which only __alcd_max_x are visible.
+ *  With __alcd_Flip_Enable and alcd_flipMode(true), the framebuffer is
+ *  double-buffered in DDRAM: page 0 is columns 0 to __alcd_max_x-1, page 1
+ *  the next __alcd_max_x columns. alcd_flush() writes the changed cells
+ *  into the hidden page while the other one stays on screen, then flips
+ *  with __alcd_max_x display shift commands (page 1: shift left, page 0:
+ *  shift right). The flip takes about __alcd_max_x command times (0.8 ms at
+ *  16 columns), far below the liquid crystal response time, so a complex
+ *  screen changes from one complete frame to the next with no partial
+ *  update visible, however slow the bus is. A flush that finds the visible
+ *  page already up to date does not flip.
+ *  The hidden page holds the frame before last, so a flush sends the cells
+ *  that changed over two frames. Urgent cells (alcd_fbPriority) go straight
+ *  to the visible page. The direct API (alcd_gotoxy/alcd_putc) writes to
+ *  the visible page and through to the framebuffer, so the hidden page
+ *  catches up with the next flush; after a flip, the next alcd_putc()
+ *  re-addresses the cursor on the new visible page.
+ *  alcd_clear() and Return Home reset the display shift to page 0.
+ * ============================================================================ */
+#ifdef __alcd_Flip_Enable
+    #if 2 * __alcd_max_x > __alcd_DDRAM_Columns
+        #error "Page flip needs two pages of __alcd_max_x columns in the DDRAM line"
+    #endif
+    extern bool __alcd_flipActive;           /**< Flip mode selected by alcd_flipMode() */
+    #define __alcd_flipShown()   ((__alcd_flipActive && __alcd_vlcd.shift == __alcd_max_x) ? __alcd_max_x : 0)  /**< DDRAM column of the visible page */
+    #define __alcd_flipHidden()  (__alcd_flipActive ? __alcd_max_x - __alcd_flipShown() : 0)               /**< DDRAM column alcd_flush() writes to */
+#else
+    #define __alcd_flipShown()   (0)                                    /**< Framebuffer maps to columns 0.. */
+    #define __alcd_flipHidden()  (0)
+#endif
+
+
+/* ============================================================================
+ *                         GRAPHIC MODE (WS0010 OLED)
+ * ============================================================================
+ *  With __alcd_Graphic_Enable, WS0010 based character OLEDs can be switched
+ *  into their graphic mode. The pixel framebuffer __alcd_gfx holds one byte
+ *  per column and page (8 pixel rows, bit 0 at the top), which is the
+ *  format the controller expects. Changed columns are tracked in a dirty
+ *  bitmap and alcd_gfxFlush() uploads only those, as runs addressed with
+ *  GXA (0x80 | column) and GYA (0x40 | page) and auto-incremented data.
+ *  While graphic mode is active, text output only updates the text
+ *  framebuffer (as with a hidden display); returning to text mode clears
+ *  the controller and flushes the text framebuffer again.
+ * ============================================================================ */
+#ifndef __alcd_Gfx_Width
+    #define __alcd_Gfx_Width    100          /**< Graphic columns (WS0010 16x2: 100) */
+#endif
+#ifndef __alcd_Gfx_Pages
+    #define __alcd_Gfx_Pages    2            /**< Graphic pages of 8 pixel rows (16x2: 2) */
+#endif
+#define __alcd_Gfx_Height       (__alcd_Gfx_Pages * 8)  /**< Graphic rows in pixels */
+#define __alcd_Gfx_GraphicMode  0x1F         /**< Mode/power command: graphic mode, internal power on */
+#define __alcd_Gfx_TextMode     0x17         /**< Mode/power command: character mode, internal power on */
+#define __alcd_Gfx_ModeMask     0xF3         /**< Mode/power commands match 0x13 under this mask */
+#define __alcd_Gfx_X            0x80         /**< Set graphic X address (column) */
+#define __alcd_Gfx_Y            0x40         /**< Set graphic Y address (page) */
+
+#ifdef __alcd_Graphic_Enable
+    extern uint8_t __alcd_gfx[__alcd_Gfx_Pages][__alcd_Gfx_Width];  /**< Pixel framebuffer, column bytes */
+    extern bool __alcd_gfxActive;            /**< Graphic mode selected */
+    #define __alcd_textActive()  (!__alcd_gfxActive)                    /**< Text output reaches the controller */
+#else
+    #define __alcd_textActive()  (true)                                 /**< Always text mode */
+#endif
+
+
+/* ============================================================================
+ *                         HEADLESS OPERATION
+ * ============================================================================
+ *  With __alcd_Headless_Enable, alcd_init() probes whether a display is
+ *  fitted and stores the result in __alcd_present:
+ *  - Strap pin (__alcd_Strap_GPIO_Port/__alcd_Strap_Pin, input with pull):
+ *    the display is fitted when the pin reads __alcd_Strap_Fitted. This
+ *    is decided before the power-on delay, so boot time is not affected.
+ *  - Busy flag (__alcd_RW_GPIO_Port/__alcd_RW_Pin, RW wired to a GPIO):
+ *    a Clear command is sent and DB7 is read with a pull-down while the
+ *    controller is busy. A fitted display drives the busy flag high;
+ *    every data pin is an input during the read.
+ *  Without a display, alcd_write() and all delays return at once. The
+ *  controller mirror and framebuffer are still maintained (so alcd_dump()
+ *  or Modbus can show the screen elsewhere) unless __alcd_Headless_NoShadow
+ *  is defined, which also makes alcd_putc() and alcd_flush() return at once.
+ * ============================================================================ */
+#ifdef __alcd_Headless_Enable
+    #if !defined(__alcd_Strap_GPIO_Port) && !defined(__alcd_RW_GPIO_Port)
+        #error "__alcd_Headless_Enable requires a strap pin (__alcd_Strap_GPIO_Port) or the RW pin (__alcd_RW_GPIO_Port)"
+    #endif
+    #ifndef __alcd_Strap_Fitted
+        #define __alcd_Strap_Fitted GPIO_PIN_RESET  /**< Strap level when the display is fitted */
+    #endif
+    extern bool __alcd_present;              /**< Display detected by alcd_init() */
+#endif
+
+
+/* ============================================================================
+ *                         CLOCK WIDGET
+ * ============================================================================
+ *  With __alcd_Clock_Enable, alcd_clockTick() only counts seconds from the
+ *  RTC interrupt; alcd_clockTask() advances the time and writes HH:MM:SS,
+ *  DD/MM/YYYY and the big HH:MM digits through alcd_fbSet(). Big digits
+ *  are 3 cells wide and 2 rows high, built from five CGRAM glyphs (upper
+ *  bar, lower bar, both bars, full block, colon dot):
+ *      H H : M M  =  3 + 1 + 3 + 1 + 3 + 1 + 3 = 15 cells on two rows
+ * ============================================================================ */
+#ifndef __alcd_Clock_BigSlot
+    #define __alcd_Clock_BigSlot    3        /**< First of five CGRAM slots used by the big digits (0-3) */
+#endif
+#if __alcd_Clock_BigSlot > 3
+    #error "__alcd_Clock_BigSlot must leave room for five glyphs (0-3)"
+#endif
+
+
+/* ============================================================================
+ *                         MODBUS RTU SLAVE
+ * ============================================================================
+ *  With __alcd_Modbus_Enable, frames are received by DMA straight into
+ *  __alcd_mbBuffer and delimited by the UART idle line. alcd_modbusTask()
+ *  decodes the frame in place, writes register values directly into the
+ *  framebuffer and builds the response in the same buffer.
+ *
+ *  Holding register map (function codes 0x03, 0x06, 0x10):
+ *  0x0000 + n   Cells 2n (high byte) and 2n+1 (low byte), row by row
+ *  0x0100 + n   CGRAM rows 2n (high byte) and 2n+1 (low byte), 8 rows per glyph
+ *  0x0200       Backlight (0=OFF, 1=ON) - only if the backlight pin is defined
+ *  0x0201       Display control: bit 2 display, bit 1 cursor, bit 0 blink
+ *  0x0202       Flush control: bit 0 auto flush after each write request,
+ *               writing bit 1 flushes immediately (reads back as 0)
+ * ============================================================================ */
+#ifndef __alcd_Modbus_Address
+    #define __alcd_Modbus_Address   1        /**< Slave address (1-247) */
+#endif
+#ifndef __alcd_Modbus_BufferSize
+    #define __alcd_Modbus_BufferSize 256     /**< Receive/response buffer, maximum RTU frame size */
+#endif
+#ifndef __alcd_Modbus_TxMargin
+    #define __alcd_Modbus_TxMargin  10       /**< Added to the response transmit time for the timeout, ms */
+#endif
+#define __alcd_Modbus_Cells     0x0000       /**< First cell register */
+#define __alcd_Modbus_CGRAM     0x0100       /**< First CGRAM register */
+#define __alcd_Modbus_BackLight 0x0200       /**< Backlight register */
+#define __alcd_Modbus_Display   0x0201       /**< Display control register */
+#define __alcd_Modbus_Flush     0x0202       /**< Flush control register */
+
+
+/* ============================================================================
+ *                         CAN DISPLAY PROTOCOL
+ * ============================================================================
+ *  With __alcd_CAN_Enable, received frames are decoded by alcd_canFrame()
+ *  (called from the bxCAN RX FIFO interrupt) straight into the framebuffer.
+ *  Standard identifiers relative to __alcd_CAN_BaseID:
+ *  Base + 0x00        Cell run: data[0]=row, data[1]=column, data[2..7]=1-6 characters
+ *  Base + 0x01        Page select: data[0]=page number
+ *  Base + 0x10 + n    Glyph of custom character n (0-7): data[0..7]=rows
+ *  On the master, alcd_canEncode() produces cell-run frames for changed
+ *  cells only, so a screen update costs one frame per run of changes.
+ * ============================================================================ */
+#ifndef __alcd_CAN_BaseID
+    #define __alcd_CAN_BaseID       0x640    /**< First standard identifier of the display */
+#endif
+#define __alcd_CAN_Cells        0x00         /**< Cell run frame offset */
+#define __alcd_CAN_Page         0x01         /**< Page select frame offset */
+#define __alcd_CAN_Glyph        0x10         /**< Glyph frame offset (+ slot) */
+#define __alcd_CAN_RunMax       6            /**< Characters per cell run frame */
+
+
+/* ============================================================================
+ *                         STATISTICS
+ * ============================================================================
+ *  With __alcd_Stats_Enable defined, alcd_write() accounts every byte in
+ *  __alcd_stats. The structure can be read directly by the application or
+ *  from a debugger watch window. Combined with __alcd_byteTime these figures
+ *  give the bus utilization and CPU blocking of a workload:
+ *      bus utilization = waitUs / measurement window
+ *      CPU blocking    = busyCycles / SystemCoreClock per second
+ * ============================================================================ */
+typedef struct
+{
+    uint32_t commands;                       /**< Command bytes written (RS=0) */
+    uint32_t data;                           /**< Data bytes written (RS=1) */
+    uint32_t enPulses;                       /**< EN strobes generated */
+    uint32_t waitUs;                         /**< Microseconds spent in busy-wait delays */
+    uint32_t busyCycles;                     /**< CPU cycles spent inside alcd_write() (DWT) */
+} alcd_stats_t;
+
+#ifdef __alcd_Stats_Enable
+    extern alcd_stats_t __alcd_stats;        /**< Bus and timing counters */
+#endif
+
+
+/* ============================================================================
+ *                         COST ATTRIBUTION PROFILER
+ * ============================================================================
+ *  With __alcd_Profile_Enable, every counter of __alcd_stats is also added
+ *  to the tag selected with alcd_tag(id), so the bus time can be split by
+ *  screen or widget. Framebuffer cells remember the tag that wrote them
+ *  (alcd_fbSet/fbPutc/fbPuts, print contexts, alcd_fbClear), and
+ *  alcd_flush() charges each cell it sends to that tag, no matter which
+ *  tag is current when the flush runs. The flush itself (count and total
+ *  cycles) is charged to the tag current at the call.
+ *
+ *  __alcd_profile.tag[] is a fixed table that can be read from a debugger
+ *  watch window; slot 0 collects untagged costs (ID 0) and calls that find
+ *  the table full. alcd_profileReport() prints the tags ranked by CPU time
+ *  blocked on the bus (bus.busyCycles).
+ * ============================================================================ */
+#ifndef __alcd_Profile_Tags
+    #define __alcd_Profile_Tags     16       /**< Tag slots, including the untagged slot 0 */
+#endif
+
+typedef struct
+{
+    uint16_t id;                             /**< ID passed to alcd_tag(), 0 = untagged */
+    alcd_stats_t bus;                        /**< Bytes, EN strobes, wait and blocking time under this tag */
+    uint32_t flushes;                        /**< alcd_flush() calls made under this tag */
+    uint32_t flushCycles;                    /**< CPU cycles of those flushes (DWT) */
+} alcd_tagCost_t;
+
+typedef struct
+{
+    uint8_t current;                         /**< Slot costs are charged to */
+    uint8_t count;                           /**< Slots in use */
+    uint32_t overflow;                       /**< alcd_tag() calls charged to slot 0 because the table was full */
+    alcd_tagCost_t tag[__alcd_Profile_Tags]; /**< Cost per tag, in order of first use */
+} alcd_profile_t;
+
+#ifdef __alcd_Profile_Enable
+    #ifndef __alcd_Stats_Enable
+        #error "__alcd_Profile_Enable requires __alcd_Stats_Enable"
+    #endif
+    #if __alcd_Profile_Tags < 2 || __alcd_Profile_Tags > 255
+        #error "__alcd_Profile_Tags must be between 2 and 255"
+    #endif
+    extern alcd_profile_t __alcd_profile;    /**< Cost per tag */
+    #define __alcd_statsCount(_field, _value)  (__alcd_stats._field += (_value), \
+                                                __alcd_profile.tag[__alcd_profile.current].bus._field += (_value))  /**< Add to statistics and current tag */
+#elif defined(__alcd_Stats_Enable)
+    #define __alcd_statsCount(_field, _value)  (__alcd_stats._field += (_value))  /**< Add to a statistics counter */
+#else
+    #define __alcd_statsCount(_field, _value)  ((void)0)                          /**< Statistics disabled */
+#endif
+
+
+/* ============================================================================
+ *                         TIMING SELF-TEST
+ * ============================================================================
+ *  With __alcd_Timing_Enable, the EN line (or a jumpered copy of it) is fed
+ *  to a timer input-capture channel that captures both edges, e.g. TI1 on
+ *  CH1 (rising) and CH2 (falling, indirect). The capture callback passes
+ *  each stamp to alcd_timingEdge(), which measures
+ *      pulse width  EN rising -> falling   (PWEH)
+ *      cycle time   EN rising -> rising    (tcycE), within a burst
+ *  alcd_timingReport() prints min/avg/max in ns against the minimums
+ *  below (HD44780 at 3.3V; override for the fitted controller).
+ *  Ticks are converted to ns in 64 bits, so __alcd_Timing_TimerHz may be
+ *  any frequency (below 1 GHz a tick is more than 1 ns). Cycles are only
+ *  measured when the previous rising edge is less than one counter period
+ *  old, so choose the prescaler so that the counter period is above the
+ *  byte time (e.g. 8 MHz with a 16-bit counter: 8.19 ms).
+ * ============================================================================ */
+#ifndef __alcd_Timing_TimerHz
+    #define __alcd_Timing_TimerHz   8000000  /**< Capture timer counting frequency in Hz */
+#endif
+#if defined(__alcd_Timing_Enable) && (__alcd_Timing_TimerHz < 1)
+    #error "__alcd_Timing_TimerHz must be at least 1 Hz"
+#endif
+#ifndef __alcd_Timing_Mask
+    #define __alcd_Timing_Mask      0xFFFF   /**< Capture counter width (0xFFFF for 16-bit timers) */
+#endif
+#ifndef __alcd_Timing_MinPulse
+    #define __alcd_Timing_MinPulse  450      /**< Minimum EN high width in ns (PWEH) */
+#endif
+#ifndef __alcd_Timing_MinCycle
+    #define __alcd_Timing_MinCycle  1000     /**< Minimum EN cycle time in ns (tcycE) */
+#endif
+
+typedef struct
+{
+    uint32_t min;                            /**< Shortest interval in timer ticks */
+    uint32_t max;                            /**< Longest interval in timer ticks */
+    uint64_t sum;                            /**< Sum of intervals for the average */
+    uint32_t count;                          /**< Number of intervals */
+} alcd_timingStat_t;
+
+typedef struct
+{
+    alcd_timingStat_t pulse;                 /**< EN high width */
+    alcd_timingStat_t cycle;                 /**< EN rising to rising */
+    uint32_t violations;                     /**< Intervals below the profile minimums */
+} alcd_timing_t;
+
+#ifdef __alcd_Timing_Enable
+    extern alcd_timing_t __alcd_timing;      /**< Measured EN timing */
+#endif
+
+
+/* ============================================================================
+ *                         ARENA ALLOCATOR
+ * ============================================================================
+ *  With __alcd_Arena_Enable, display subsystems (layers, widgets, glyph
+ *  registry, display lists) take their memory from one static arena of
+ *  __alcd_Arena_Size bytes instead of a heap. At startup each user carves a
+ *  pool of fixed-size blocks out of it with alcd_poolCreate() (or
+ *  alcd_poolCreateOf() for a type); pools are never returned to the arena.
+ *  alcd_poolAlloc()/alcd_poolFree() are O(1) free-list operations and a
+ *  pool cannot fragment. Block sizes are rounded up to the pointer size
+ *  (4 bytes on Cortex-M), the free-list link lives in the free block.
+ *  RAM use is fixed at link time; alcd_arenaReport() prints arena use and
+ *  per-pool high-water marks, the same numbers are in __alcd_arena.
+ * ============================================================================ */
+#ifndef __alcd_Arena_Size
+    #define __alcd_Arena_Size       1024     /**< Arena size in bytes */
+#endif
+#ifndef __alcd_Arena_Pools
+    #define __alcd_Arena_Pools      8        /**< Maximum number of pools */
+#endif
+
+typedef struct
+{
+    const char *name;                        /**< Pool name for the report */
+    uint8_t *base;                           /**< First block in the arena */
+    void *free;                              /**< Free list head (link stored in the block) */
+    uint16_t blockSize;                      /**< Block size in bytes (multiple of the pointer size) */
+    uint16_t blocks;                         /**< Number of blocks */
+    uint16_t used;                           /**< Blocks currently allocated */
+    uint16_t highWater;                      /**< Most blocks allocated at once */
+    uint16_t failed;                         /**< Allocations refused because the pool was empty */
+} alcd_pool_t;
+
+typedef struct
+{
+    uint32_t used;                           /**< Arena bytes given to pools */
+    uint8_t count;                           /**< Pools created */
+    alcd_pool_t pool[__alcd_Arena_Pools];    /**< Pool descriptors */
+} alcd_arena_t;
+
+#ifdef __alcd_Arena_Enable
+    extern alcd_arena_t __alcd_arena;        /**< Arena and pool usage */
+    #define alcd_poolCreateOf(_type, _count)  alcd_poolCreate(#_type, sizeof(_type), (_count))  /**< Typed pool */
+#endif
+
+
+/* ============================================================================
+ *                         ENERGY ACCOUNTING
+ * ============================================================================
+ *  With __alcd_Energy_Enable, the statistics counters are converted into an
+ *  energy estimate using the coefficients below (set them from board
+ *  measurements). Units: mW * us = nJ, nJ / ms = uW. Products are formed
+ *  in 64 bits and the results saturate at UINT32_MAX instead of wrapping.
+ *      bus energy       = enPulses * __alcd_Energy_EnPulse
+ *                       + bytes    * __alcd_Energy_Byte
+ *                       + waitUs   * __alcd_Energy_CpuPower
+ *      backlight energy = ON time * dim level * __alcd_Energy_BLPower
+ *  Once per __alcd_Energy_Window, alcd_energyTask() compares the average
+ *  power with __alcd_Energy_Budget and moves the policy level by one step
+ *  (up when over budget, down below 80% of it):
+ *      0  normal operation
+ *      1  batch updates: activity no longer forces an immediate flush,
+ *         refresh period at least 4 x __alcd_Gov_MinPeriod
+ *      2  lowest refresh rate (__alcd_Gov_MaxPeriod)
+ *      3  backlight dimmed to 50%
+ *      4  backlight dimmed to 25%
+ *  Refresh steps act through the governor (alcd_task); dimming goes through
+ *  alcd_energyDimCallback(), which can drive a PWM backlight.
+ * ============================================================================ */
+#ifndef __alcd_Energy_EnPulse
+    #define __alcd_Energy_EnPulse   20       /**< Energy per EN strobe in nJ (bus line switching) */
+#endif
+#ifndef __alcd_Energy_Byte
+    #define __alcd_Energy_Byte      50       /**< Controller energy per transferred byte in nJ */
+#endif
+#ifndef __alcd_Energy_CpuPower
+    #define __alcd_Energy_CpuPower  100      /**< MCU active power while busy-waiting in mW */
+#endif
+#ifndef __alcd_Energy_BLPower
+    #define __alcd_Energy_BLPower   75       /**< Backlight power at full brightness in mW */
+#endif
+#ifndef __alcd_Energy_Budget
+    #define __alcd_Energy_Budget    20       /**< Average power budget of the display subsystem in mW */
+#endif
+#ifndef __alcd_Energy_Window
+    #define __alcd_Energy_Window    1000     /**< Policy evaluation window in ms */
+#endif
+#define __alcd_Energy_Levels    4            /**< Highest policy level */
+
+typedef struct
+{
+    uint32_t flushNj;                        /**< Energy of the last alcd_flush() in nJ */
+    uint32_t busUw;                          /**< Average bus and MCU power of the last window in uW */
+    uint32_t backlightUw;                    /**< Average backlight power of the last window in uW */
+    uint32_t totalUw;                        /**< busUw + backlightUw */
+    uint8_t backlightDuty;                   /**< Backlight ON time of the last window in percent */
+    uint8_t dim;                             /**< Applied backlight level in percent */
+    uint8_t level;                           /**< Policy level (0 to __alcd_Energy_Levels) */
+} alcd_energy_t;
+
+#ifdef __alcd_Energy_Enable
+    #ifndef __alcd_Stats_Enable
+        #error "__alcd_Energy_Enable requires __alcd_Stats_Enable"
+    #endif
+    extern alcd_energy_t __alcd_energy;      /**< Energy estimate and policy state */
+#endif
+
+
+/* ============================================================================
+ *                         RENDERER (CGROM FONT)
+ * ============================================================================
+ *  Renders the mirrored display through a CGROM font table (codes 0x20-0x7F
+ *  of the A00 or A02 ROM) plus the mirrored CGRAM for codes 0x00-0x0F.
+ *  Glyph rows use the CGRAM format: 8 rows, bit 4 is the leftmost pixel.
+ *  Codes outside the table render as a hatched cell.
+ * ============================================================================ */
+#define __alcd_Glyph_Width    5              /**< Glyph width in pixels */
+#define __alcd_Glyph_Height   8              /**< Glyph height in pixels (including cursor row) */
+
+
+/* ============================================================================
+ *                         SMOOTH SCROLL
+ * ============================================================================
+ *  With __alcd_Scroll_Enable, a window of up to 8 cells shows custom
+ *  characters 0..width-1, and the text is rendered from the CGROM font
+ *  table into these CGRAM tiles. Each alcd_scrollStep() moves the text by
+ *  one pixel column while the DDRAM cells stay fixed; only CGRAM rows whose
+ *  content changed are written. The window uses the low CGRAM slots, so
+ *  those are not available for other custom characters while it runs.
+ * ============================================================================ */
+#define __alcd_Scroll_MaxWidth  8            /**< Maximum window width in cells (CGRAM slots) */
+#define __alcd_Scroll_Pitch     6            /**< Text pixel columns per character (5 + 1 gap) */
+
+
 /* ============================================================================
  *                         FUNCTION PROTOTYPES
  * ============================================================================ */
@@ -161,6 +1020,11 @@ void alcd_putc(char _char);
  */
 void alcd_puts(char* _str);
 
+/**
+ * @brief Print pre-encoded ROM codes with known length (no scanning)
+ */
+void alcd_putn(const uint8_t *_alcd_codes, uint8_t _alcd_length);
+
 /**
  * @brief Move cursor to specified row and column
  */
@@ -188,4 +1052,534 @@ void alcd_customChar(uint8_t _alcd_CGRAMadd, const uint8_t *_alcd_CGRAMdata);
     void alcd_backLight(bool _alcd_BL);
 #endif
 
+/**
+ * @brief Copy a consistent snapshot of the controller mirror
+ */
+void alcd_snapshot(alcd_vlcd_t *_alcd_copy);
+
+/**
+ * @brief Move framebuffer cursor to specified row and column
+ */
+void alcd_fbGotoxy(uint8_t _alcd_x, uint8_t _alcd_y);
+
+/**
+ * @brief Write single character into the framebuffer
+ */
+void alcd_fbPutc(char _char);
+
+/**
+ * @brief Write null-terminated string into the framebuffer
+ */
+void alcd_fbPuts(const char* _str);
+
+/**
+ * @brief Write pre-encoded ROM codes with known length into the framebuffer
+ */
+void alcd_fbPutn(const uint8_t *_alcd_codes, uint8_t _alcd_length);
+
+/**
+ * @brief Fill the framebuffer with spaces and home its cursor
+ */
+void alcd_fbClear(void);
+
+/**
+ * @brief Send framebuffer cells that differ from the LCD contents
+ */
+uint16_t alcd_flush(void);
+
+#ifdef __alcd_Serial_Enable
+/**
+ * @brief Start an I2C transaction (provided by the library when __alcd_Serial_I2C is defined)
+ */
+bool alcd_serialTransmit(const uint8_t *_data, uint16_t _length);
+
+/**
+ * @brief Transaction complete (call from the I2C transfer complete and error callbacks)
+ */
+void alcd_serialTxDone(void);
+
+/**
+ * @brief Abort a transaction that timed out (provided by the library when __alcd_Serial_I2C is defined)
+ */
+bool alcd_serialAbort(void);
+#endif
+
+#ifdef __alcd_Queue_Enable
+/**
+ * @brief Queue a CGRAM glyph for the next alcd_flush(), a newer pattern replaces a pending one
+ */
+void alcd_fbGlyph(uint8_t _alcd_slot, const uint8_t *_alcd_pattern);
+
+/**
+ * @brief Number of pending cells and glyphs
+ */
+uint16_t alcd_queueDepth(void);
+#endif
+
+#ifdef __alcd_History_Enable
+/**
+ * @brief Program queued history records into flash (call from the main loop)
+ */
+void alcd_historyTask(void);
+
+/**
+ * @brief Print all history records oldest first as hex lines
+ */
+void alcd_historyDump(void);
+
+/**
+ * @brief Timestamp of history records (weak, default HAL tick in ms)
+ */
+uint32_t alcd_historyTime(void);
+#endif
+
+#ifdef __alcd_Flip_Enable
+/**
+ * @brief Enable or disable page flipping for alcd_flush()
+ */
+void alcd_flipMode(bool _alcd_flip);
+#endif
+
+/**
+ * @brief Write one framebuffer cell without moving the framebuffer cursor
+ */
+void alcd_fbSet(uint8_t _alcd_x, uint8_t _alcd_y, char _char);
+
+/**
+ * @brief Mark a run of cells as urgent or normal priority
+ */
+void alcd_fbPriority(uint8_t _alcd_x, uint8_t _alcd_y, uint8_t _alcd_length, bool _alcd_urgent);
+
+/**
+ * @brief Set up a print context for a screen region
+ */
+void alcd_ctxInit(alcd_ctx_t *_alcd_ctx, uint8_t _alcd_x, uint8_t _alcd_y, uint8_t _alcd_width, uint8_t _alcd_height, bool _alcd_wrap);
+
+/**
+ * @brief Move the context cursor, relative to its region
+ */
+void alcd_ctxGotoxy(alcd_ctx_t *_alcd_ctx, uint8_t _alcd_x, uint8_t _alcd_y);
+
+/**
+ * @brief Write single character at the context cursor
+ */
+void alcd_ctxPutc(alcd_ctx_t *_alcd_ctx, char _char);
+
+/**
+ * @brief Write null-terminated string at the context cursor
+ */
+void alcd_ctxPuts(alcd_ctx_t *_alcd_ctx, const char* _str);
+
+/**
+ * @brief Write pre-encoded ROM codes with known length at the context cursor
+ */
+void alcd_ctxPutn(alcd_ctx_t *_alcd_ctx, const uint8_t *_alcd_codes, uint8_t _alcd_length);
+
+/**
+ * @brief Fill the context region with spaces and home its cursor
+ */
+void alcd_ctxClear(alcd_ctx_t *_alcd_ctx);
+
+#ifdef __alcd_Governor_Enable
+/**
+ * @brief Flush the framebuffer when the adaptive refresh period has elapsed
+ */
+void alcd_task(void);
+
+/**
+ * @brief Report user interaction to raise the refresh rate immediately
+ */
+void alcd_activity(void);
+
+/**
+ * @brief Mark the start of an idle period for CPU load measurement
+ */
+void alcd_idleEnter(void);
+
+/**
+ * @brief Mark the end of an idle period for CPU load measurement
+ */
+void alcd_idleExit(void);
+#endif
+
+#ifdef __alcd_Clock_Enable
+/**
+ * @brief Place the HH:MM:SS clock widget on the screen
+ */
+void alcd_clockInit(uint8_t _alcd_x, uint8_t _alcd_y);
+
+/**
+ * @brief Show the DD/MM/YYYY date at the given position
+ */
+void alcd_clockDate(uint8_t _alcd_x, uint8_t _alcd_y);
+
+/**
+ * @brief Show HH:MM in big digits on two rows
+ */
+void alcd_clockBig(uint8_t _alcd_x, uint8_t _alcd_y);
+
+/**
+ * @brief Set the current time of the clock widget
+ */
+void alcd_clockSet(uint8_t _alcd_hour, uint8_t _alcd_minute, uint8_t _alcd_second);
+
+/**
+ * @brief Set the current date of the clock widget
+ */
+void alcd_clockSetDate(uint8_t _alcd_day, uint8_t _alcd_month, uint16_t _alcd_year);
+
+/**
+ * @brief Signal one elapsed second (call from the RTC second interrupt)
+ */
+void alcd_clockTick(void);
+
+/**
+ * @brief Advance and redraw the clock widget (call from the main loop)
+ */
+void alcd_clockTask(void);
+#endif
+
+#ifdef __alcd_Graphic_Enable
+/**
+ * @brief Switch between text mode and graphic mode
+ */
+void alcd_gfxMode(bool _alcd_graphic);
+
+/**
+ * @brief Clear the pixel framebuffer
+ */
+void alcd_gfxClear(void);
+
+/**
+ * @brief Set or clear one pixel in the pixel framebuffer
+ */
+void alcd_gfxPixel(uint8_t _alcd_x, uint8_t _alcd_y, bool _alcd_on);
+
+/**
+ * @brief Copy a page-format bitmap into the pixel framebuffer
+ */
+void alcd_gfxBitmap(uint8_t _alcd_x, uint8_t _alcd_page, uint8_t _alcd_width, uint8_t _alcd_pages, const uint8_t *_alcd_bitmap);
+
+/**
+ * @brief Upload dirty columns of the pixel framebuffer
+ */
+uint16_t alcd_gfxFlush(void);
+#endif
+
+#ifdef __alcd_Lazy_Enable
+/**
+ * @brief Report whether the operator can see the display (e.g. panel lid)
+ */
+void alcd_panelVisible(bool _alcd_visible);
+#endif
+
+#ifdef __alcd_Modbus_Enable
+/**
+ * @brief Start DMA reception of Modbus requests
+ */
+void alcd_modbusStart(void);
+
+/**
+ * @brief Signal a received frame (call from HAL_UARTEx_RxEventCallback)
+ */
+void alcd_modbusRxEvent(UART_HandleTypeDef *_huart, uint16_t _size);
+
+/**
+ * @brief Process a pending Modbus request and send the response
+ */
+void alcd_modbusTask(void);
+
+/**
+ * @brief Process one Modbus RTU request in place and build the response
+ */
+uint16_t alcd_modbusProcess(uint8_t *_frame, uint16_t _length);
+#endif
+
+#ifdef __alcd_CAN_Enable
+/**
+ * @brief Decode a received display frame (call from the CAN RX interrupt)
+ */
+bool alcd_canFrame(uint32_t _id, const uint8_t *_data, uint8_t _length);
+
+/**
+ * @brief Upload received glyphs, handle page select and flush
+ */
+void alcd_canTask(void);
+
+/**
+ * @brief Page select callback, called from alcd_canTask() (weak, override in application)
+ */
+void alcd_canPageCallback(uint8_t _page);
+
+/**
+ * @brief Build the next cell run frame for cells that differ from the remote copy
+ */
+uint8_t alcd_canEncode(uint8_t _remote[__alcd_max_y][__alcd_max_x], uint32_t *_id, uint8_t *_data);
+#endif
+
+#ifdef __alcd_Stats_Enable
+/**
+ * @brief Reset bus and timing counters
+ */
+void alcd_statsReset(void);
+#endif
+
+#ifdef __alcd_Profile_Enable
+/**
+ * @brief Charge following bus costs to a screen or widget ID, returns the previous ID
+ */
+uint16_t alcd_tag(uint16_t _alcd_id);
+
+/**
+ * @brief Clear all tag costs (the current tag stays selected)
+ */
+void alcd_profileReset(void);
+
+/**
+ * @brief Print the tags ranked by bus cost
+ */
+void alcd_profileReport(void);
+#endif
+
+#ifdef __alcd_Timing_Enable
+/**
+ * @brief Clear the EN timing measurements
+ */
+void alcd_timingReset(void);
+
+/**
+ * @brief Feed one captured EN edge (call from the input-capture callback)
+ */
+void alcd_timingEdge(uint32_t _stamp, bool _rising);
+
+/**
+ * @brief Print EN timing min/avg/max against the profile minimums
+ */
+bool alcd_timingReport(void);
+#endif
+
+#ifdef __alcd_Arena_Enable
+/**
+ * @brief Carve a pool of fixed-size blocks out of the arena
+ */
+alcd_pool_t *alcd_poolCreate(const char *_name, uint16_t _size, uint16_t _count);
+
+/**
+ * @brief Allocate one block, NULL when the pool is empty
+ */
+void *alcd_poolAlloc(alcd_pool_t *_pool);
+
+/**
+ * @brief Return a block to its pool
+ */
+void alcd_poolFree(alcd_pool_t *_pool, void *_block);
+
+/**
+ * @brief Print arena use and per-pool high-water marks
+ */
+void alcd_arenaReport(void);
+#endif
+
+#ifdef __alcd_Energy_Enable
+/**
+ * @brief Evaluate the power budget and adjust the policy level
+ */
+void alcd_energyTask(void);
+
+/**
+ * @brief Backlight dimming callback (weak, override for PWM backlight)
+ */
+uint8_t alcd_energyDimCallback(uint8_t _percent);
+#endif
+
+#ifdef __alcd_Scroll_Enable
+/**
+ * @brief Start a pixel-smooth ticker in a window of CGRAM tiles
+ */
+void alcd_scrollStart(uint8_t _alcd_x, uint8_t _alcd_y, uint8_t _alcd_width, const char *_alcd_text);
+
+/**
+ * @brief Move the ticker by one pixel column
+ */
+uint8_t alcd_scrollStep(void);
+
+/**
+ * @brief Stop the ticker and blank its window
+ */
+void alcd_scrollStop(void);
+#endif
+
+#ifdef __alcd_Render_Enable
+/**
+ * @brief Render one character code into 8 glyph rows
+ */
+void alcd_renderGlyph(const alcd_vlcd_t *_alcd_frame, uint8_t _alcd_code, uint8_t *_alcd_rows);
+
+/**
+ * @brief Print the visible display as ASCII art via printf()
+ */
+void alcd_dump(void);
+
+/**
+ * @brief Calculate a hash of the rendered visible display
+ */
+uint32_t alcd_renderHash(void);
+#endif
+
+#ifdef __cplusplus
+}
+
+
+/* ============================================================================
+ *                         C++ COMPILE-TIME TEXT ENCODING
+ * ============================================================================
+ *  alcd::rom() converts a UTF-8 string literal into HD44780 ROM codes while
+ *  compiling (C++14 or later; consteval with C++20). The result lives in
+ *  flash and is printed with alcd_puts()/alcd_fbPuts() overloads that only
+ *  copy bytes, without run-time mapping or length scanning:
+ *      static constexpr auto _title = alcd::rom(u8"Temp 23°C");
+ *      alcd_puts(_title);
+ *  A character the selected ROM (A00, or A02 with __alcd_CGROM_A02) cannot
+ *  show stops compilation with an error that names
+ *  alcd::unmappable_character_in_lcd_text. "\x01" to "\x07" select custom
+ *  characters 1-7.
+ * ============================================================================ */
+#ifdef __cpp_consteval
+    #define __alcd_consteval consteval       /**< Always evaluated while compiling */
+#else
+    #define __alcd_consteval constexpr       /**< Compile time when stored in a constexpr variable */
+#endif
+
+namespace alcd
+{
+    /**
+     * @brief Encoded text: ROM codes and their number
+     */
+    template<unsigned N> struct romText
+    {
+        uint8_t codes[N];                    /**< HD44780 ROM codes */
+        uint8_t length;                      /**< Number of valid codes */
+    };
+
+    /**
+     * @brief Deliberately not defined: reaching it in a constant expression is a compile error
+     */
+    void unmappable_character_in_lcd_text(void);
+
+    /* -------------------------------------------------------
+     * @brief Map one Unicode code point to a ROM code
+     * @param _code: Unicode code point
+     * @retval ROM code
+     * ------------------------------------------------------- */
+    constexpr uint8_t romCode(uint32_t _code)
+    {
+        if((_code >= 0x01 && _code <= 0x07) || (_code >= 0x20 && _code <= 0x7D && _code != 0x5C))
+        {
+            return (uint8_t)_code;                                 /**< Custom characters and common ASCII */
+        };
+
+        #ifdef __alcd_CGROM_A02
+        if(_code == 0x5C || _code == 0x7E || (_code >= 0xA0 && _code <= 0xFF))
+        {
+            return (uint8_t)_code;                                 /**< A02 follows Latin-1 here */
+        };
+        #else
+        if(_code >= 0xFF61 && _code <= 0xFF9F)
+        {
+            return (uint8_t)(_code - 0xFF61 + 0xA1);               /**< Half-width katakana (JIS X 0201) */
+        };
+        switch(_code)
+        {
+            case 0x00A5: return 0x5C;                              /**< Yen sign */
+            case 0x2192: return 0x7E;                              /**< Right arrow */
+            case 0x2190: return 0x7F;                              /**< Left arrow */
+            case 0x00B0: return 0xDF;                              /**< Degree sign */
+            case 0x03B1: return 0xE0;                              /**< Alpha */
+            case 0x00E4: return 0xE1;                              /**< a umlaut */
+            case 0x00DF:
+            case 0x03B2: return 0xE2;                              /**< Beta / sharp s */
+            case 0x03B5: return 0xE3;                              /**< Epsilon */
+            case 0x00B5:
+            case 0x03BC: return 0xE4;                              /**< Micro / mu */
+            case 0x03C3: return 0xE5;                              /**< Sigma */
+            case 0x03C1: return 0xE6;                              /**< Rho */
+            case 0x221A: return 0xE8;                              /**< Square root */
+            case 0x00A2: return 0xEC;                              /**< Cent sign */
+            case 0x00F1: return 0xEE;                              /**< n tilde */
+            case 0x00F6: return 0xEF;                              /**< o umlaut */
+            case 0x03B8: return 0xF2;                              /**< Theta */
+            case 0x221E: return 0xF3;                              /**< Infinity */
+            case 0x03A9: return 0xF4;                              /**< Omega */
+            case 0x00FC: return 0xF5;                              /**< u umlaut */
+            case 0x03A3: return 0xF6;                              /**< Capital sigma */
+            case 0x03C0: return 0xF7;                              /**< Pi */
+            case 0x00F7: return 0xFD;                              /**< Division sign */
+            case 0x2588: return 0xFF;                              /**< Full block */
+            default: break;
+        };
+        #endif
+
+        return unmappable_character_in_lcd_text(), 0;
+    };
+
+    /* -------------------------------------------------------
+     * @brief Encode a UTF-8 string literal into ROM codes
+     * @param _text: String literal (char or char8_t)
+     * @retval Encoded text
+     * @note Use in a constexpr variable (C++14/17) or anywhere with
+     *       C++20, so that encoding and checking happen while compiling
+     * ------------------------------------------------------- */
+    template<typename C, unsigned N> __alcd_consteval romText<N> rom(const C (&_text)[N])
+    {
+        static_assert(N <= 256, "LCD text too long");
+        romText<N> _out = {};                                      /**< Encoded result */
+        unsigned _index = 0;                                       /**< Byte index in the literal */
+        unsigned _extra = 0;                                       /**< Continuation bytes of the sequence */
+        uint32_t _code = 0;                                        /**< Decoded code point */
+
+        while(_index + 1 < N && _text[_index] != 0)
+        {
+            _code = (uint8_t)_text[_index++];
+            _extra = (_code >= 0xF0) ? 3 : (_code >= 0xE0) ? 2 : (_code >= 0xC0) ? 1 : 0;
+            if(_code >= 0x80 && _code < 0xC0)                      /**< Stray continuation byte */
+            {
+                unmappable_character_in_lcd_text();
+            };
+            _code &= 0xFF >> (_extra ? _extra + 2 : 1);            /**< Payload bits of the lead byte */
+            while(_extra--)
+            {
+                _code = (_code << 6) | ((uint8_t)_text[_index++] & 0x3F);
+            };
+            _out.codes[_out.length++] = romCode(_code);
+        };
+
+        return _out;
+    };
+};
+
+/**
+ * @brief Print compile-time encoded text at the current cursor position
+ */
+template<unsigned N> inline void alcd_puts(const alcd::romText<N> &_text)
+{
+    alcd_putn(_text.codes, _text.length);
+};
+
+/**
+ * @brief Write compile-time encoded text into the framebuffer
+ */
+template<unsigned N> inline void alcd_fbPuts(const alcd::romText<N> &_text)
+{
+    alcd_fbPutn(_text.codes, _text.length);
+};
+
+/**
+ * @brief Write compile-time encoded text at a print context cursor
+ */
+template<unsigned N> inline void alcd_ctxPuts(alcd_ctx_t *_alcd_ctx, const alcd::romText<N> &_text)
+{
+    alcd_ctxPutn(_alcd_ctx, _text.codes, _text.length);
+};
+#endif
+
 #endif /* _alcd_H_ */
\ No newline at end of file
@@ -23,10 +23,114 @@
  *           - alcd_gotoxy    : Move cursor to specific row and column position
  *           - alcd_putc      : Print single character with automatic line wrapping
  *           - alcd_puts      : Print null-terminated string at current position
+ *           - alcd_putn      : Print pre-encoded ROM codes with known length
  *
  *           Custom Characters:
  *           - alcd_customChar: Create custom character in CGRAM memory
  *
+ *           Serial Controller Backend (optional, __alcd_Serial_Enable):
+ *           - alcd_serialTransmit: Start an I2C DMA transaction (library default with __alcd_Serial_I2C)
+ *           - alcd_serialTxDone  : Transfer complete, called from the I2C callbacks
+ *           - alcd_serialAbort   : Abort a transaction that timed out (weak default without __alcd_Serial_I2C)
+ *
+ *           Controller Mirror:
+ *           - alcd_snapshot  : Copy a consistent snapshot of the mirrored controller state
+ *
+ *           Statistics (optional, __alcd_Stats_Enable):
+ *           - alcd_statsReset: Clear bus and timing counters in __alcd_stats
+ *
+ *           Cost Attribution (optional, __alcd_Profile_Enable):
+ *           - alcd_tag          : Select the screen or widget ID that following costs are charged to
+ *           - alcd_profileReset : Clear all tag costs
+ *           - alcd_profileReport: Print tags ranked by bus cost
+ *
+ *           Timing Self-Test (optional, __alcd_Timing_Enable):
+ *           - alcd_timingReset : Clear EN timing measurements
+ *           - alcd_timingEdge  : Feed captured EN edge from timer input capture
+ *           - alcd_timingReport: Print min/avg/max against profile minimums
+ *
+ *           Arena Allocator (optional, __alcd_Arena_Enable):
+ *           - alcd_poolCreate  : Carve a fixed-block pool out of the static arena
+ *           - alcd_poolAlloc   : Allocate one block in O(1)
+ *           - alcd_poolFree    : Return a block in O(1)
+ *           - alcd_arenaReport : Print arena use and pool high-water marks
+ *
+ *           Update Queue (optional, __alcd_Queue_Enable):
+ *           - alcd_fbGlyph     : Queue a CGRAM glyph, latest pattern wins
+ *           - alcd_queueDepth  : Number of pending cells and glyphs
+ *
+ *           Display History (optional, __alcd_History_Enable):
+ *           - alcd_historyTask : Program queued flush deltas into the flash ring
+ *           - alcd_historyDump : Print records oldest first for Tools/alcd_history.py
+ *           - alcd_historyTime : Record timestamp (weak, HAL tick)
+ *
+ *           Energy Accounting (optional, __alcd_Energy_Enable):
+ *           - alcd_energyTask       : Average power per window and budget policy
+ *           - alcd_energyDimCallback: Backlight dimming hook (weak)
+ *
+ *           Renderer (optional, __alcd_Render_Enable):
+ *           - alcd_renderGlyph: Render a character code through CGROM/CGRAM into glyph rows
+ *           - alcd_dump      : Print visible display as ASCII art
+ *           - alcd_renderHash: Hash of rendered display for golden-screen comparison
+ *
+ *           Smooth Scroll (optional, __alcd_Scroll_Enable):
+ *           - alcd_scrollStart: Bind a window of CGRAM tiles to a text
+ *           - alcd_scrollStep : Shift text by one pixel column, write changed CGRAM rows only
+ *           - alcd_scrollStop : Stop ticker and blank its window
+ *
+ *           Framebuffer:
+ *           - alcd_fbGotoxy  : Move framebuffer cursor
+ *           - alcd_fbPutc    : Write character into framebuffer with automatic wrapping
+ *           - alcd_fbPuts    : Write string into framebuffer
+ *           - alcd_fbPutn    : Write pre-encoded ROM codes into framebuffer
+ *           - alcd_fbClear   : Fill framebuffer with spaces
+ *           - alcd_flush     : Send only cells that differ from the LCD contents
+ *           - alcd_fbSet     : Write one cell without cursor (interrupt safe)
+ *           - alcd_fbPriority: Mark cells as urgent priority lane
+ *           - alcd_panelVisible: Panel open/closed, hold updates while invisible (__alcd_Lazy_Enable)
+ *           - alcd_flipMode  : Double-buffer in off-screen DDRAM and flip pages (__alcd_Flip_Enable)
+ *
+ *           Print Contexts:
+ *           - alcd_ctxInit   : Set up a clipped region with its own cursor
+ *           - alcd_ctxGotoxy : Move context cursor (region relative)
+ *           - alcd_ctxPutc   : Write character with clipping or wrapping inside the region
+ *           - alcd_ctxPuts   : Write string at the context cursor
+ *           - alcd_ctxPutn   : Write pre-encoded ROM codes at the context cursor
+ *           - alcd_ctxClear  : Blank the region
+ *
+ *           Graphic Mode (optional, __alcd_Graphic_Enable):
+ *           - alcd_gfxMode   : Switch WS0010 OLED between text and graphic mode
+ *           - alcd_gfxClear  : Clear pixel framebuffer
+ *           - alcd_gfxPixel  : Set or clear one pixel
+ *           - alcd_gfxBitmap : Copy page-format bitmap (logos, glyphs)
+ *           - alcd_gfxFlush  : Upload dirty columns only
+ *
+ *           Refresh Governor (optional, __alcd_Governor_Enable):
+ *           - alcd_task      : Flush framebuffer at the adaptive refresh period
+ *           - alcd_activity  : Report user interaction (switch to fastest rate)
+ *           - alcd_idleEnter : Start of idle period (CPU load measurement)
+ *           - alcd_idleExit  : End of idle period
+ *
+ *           Modbus RTU Slave (optional, __alcd_Modbus_Enable):
+ *           - alcd_modbusStart  : Start DMA reception with idle-line framing
+ *           - alcd_modbusRxEvent: Frame received, called from HAL_UARTEx_RxEventCallback
+ *           - alcd_modbusTask   : Process pending request and respond
+ *           - alcd_modbusProcess: Decode request in place and build response
+ *
+ *           CAN Display Protocol (optional, __alcd_CAN_Enable):
+ *           - alcd_canFrame        : Decode received frame, called from CAN RX interrupt
+ *           - alcd_canTask         : Upload glyphs, handle page select, flush
+ *           - alcd_canPageCallback : Page select hook (weak)
+ *           - alcd_canEncode       : Master side, next cell run frame for changed cells
+ *
+ *           Clock Widget (optional, __alcd_Clock_Enable):
+ *           - alcd_clockInit : Place HH:MM:SS clock on screen
+ *           - alcd_clockDate : Place DD/MM/YYYY date on screen
+ *           - alcd_clockBig  : Place HH:MM in big digits (3x2 cells each)
+ *           - alcd_clockSet  : Set time (alcd_clockSetDate for the date)
+ *           - alcd_clockTick : One second elapsed, called from RTC interrupt
+ *           - alcd_clockTask : Advance time and redraw changed digits
+ *
  *           Low-Level Functions:
  *           - alcd_write     : Send data/command to LCD in 8-bit mode using HAL
  *
@@ -38,184 +142,3775 @@
 #include "alcd.h"
 
 
-/* ============================================================================
- *                         GLOBAL VARIABLES
- * ============================================================================ */
-bool __alcd_initStatus = false;          /**< LCD initialization status flag - false during init, true after */
-uint8_t __alcd_x_position = 0;           /**< Current cursor column position (0-15) */
-uint8_t __alcd_y_position = 0;           /**< Current cursor row position (0-1) */
+/* ============================================================================
+ *                         GLOBAL VARIABLES
+ * ============================================================================ */
+bool __alcd_initStatus = false;          /**< LCD initialization status flag - false during init, true after */
+#ifdef __alcd_Headless_Enable
+bool __alcd_present = true;              /**< Display detected by alcd_init(), false = null transport */
+#endif
+uint8_t __alcd_x_position = 0;           /**< Current cursor column position (0-15) */
+uint8_t __alcd_y_position = 0;           /**< Current cursor row position (0-1) */
+
+uint8_t __alcd_fb[__alcd_max_y][__alcd_max_x];  /**< Shadow framebuffer, see alcd_flush() */
+uint8_t __alcd_fb_x = 0;                 /**< Framebuffer cursor column */
+uint8_t __alcd_fb_y = 0;                 /**< Framebuffer cursor row */
+bool __alcd_cursorMoved = false;         /**< LCD address counter moved away from the direct API cursor by alcd_flush() */
+uint32_t __alcd_fbUrgent[__alcd_max_y];  /**< Urgent cell mask per row, see alcd_fbPriority() */
+volatile bool __alcd_urgentPending = false;  /**< Urgent cell written and not yet flushed */
+#ifdef __alcd_Queue_Enable
+volatile uint32_t __alcd_queuePending[__alcd_max_y];  /**< Cells written since they were last flushed */
+uint8_t __alcd_queueGlyph[8][8];         /**< Newest pattern per CGRAM slot, see alcd_fbGlyph() */
+volatile uint8_t __alcd_queueGlyphPending = 0;  /**< CGRAM slots with a pattern not yet uploaded */
+#endif
+
+static uint16_t __alcd_flushUrgent(void);
+
+#ifdef __alcd_Serial_Enable
+uint8_t __alcd_serialBuffer[__alcd_Serial_BufferSize];  /**< Control/data byte pairs of the current transaction */
+uint16_t __alcd_serialLength = 0;        /**< Bytes in __alcd_serialBuffer */
+uint8_t __alcd_serialDepth = 0;          /**< Open bursts, the transaction is sent when it drops to 0 */
+volatile bool __alcd_serialBusy = false; /**< DMA transaction in flight */
+bool __alcd_serialDrop = false;          /**< Previous transaction could not be aborted: drop the current one */
+uint32_t __alcd_serialDropped = 0;       /**< Transactions dropped because the bus stayed busy */
+#endif
+
+#ifdef __alcd_Flip_Enable
+bool __alcd_flipActive = false;          /**< Flush into the hidden DDRAM page and flip, see alcd_flipMode() */
+#endif
+
+#ifdef __alcd_Graphic_Enable
+uint8_t __alcd_gfx[__alcd_Gfx_Pages][__alcd_Gfx_Width];  /**< Pixel framebuffer, column bytes with bit 0 at the top */
+uint8_t __alcd_gfxDirty[__alcd_Gfx_Pages][(__alcd_Gfx_Width + 7) / 8];  /**< Columns changed since the last upload */
+bool __alcd_gfxActive = false;           /**< Graphic mode selected */
+#endif
+
+#ifdef __alcd_Lazy_Enable
+bool __alcd_displayOn = true;            /**< Display switched on by alcd_display() */
+bool __alcd_panelOpen = true;            /**< Panel reported visible by alcd_panelVisible() */
+#if defined(__alcd_DarkPanel)
+bool __alcd_backLightOn = true;          /**< Backlight state as last set */
+#endif
+#endif
+
+#ifdef __alcd_Stats_Enable
+alcd_stats_t __alcd_stats;               /**< Bus and timing counters, see alcd_statsReset() */
+#endif
+
+#ifdef __alcd_Profile_Enable
+alcd_profile_t __alcd_profile = { .count = 1 };  /**< Cost per tag, slot 0 = untagged */
+uint8_t __alcd_tagOwner[__alcd_max_y][__alcd_max_x];  /**< Tag slot that last wrote each framebuffer cell */
+#endif
+
+#ifdef __alcd_Timing_Enable
+alcd_timing_t __alcd_timing;             /**< Measured EN timing, see alcd_timingReport() */
+uint32_t __alcd_timingRise = 0;          /**< Stamp of the last rising edge */
+uint32_t __alcd_timingRiseTick = 0;      /**< HAL tick of the last rising edge */
+bool __alcd_timingHigh = false;          /**< Rising edge seen, falling edge pending */
+bool __alcd_timingBurst = false;         /**< Previous rising edge available for a cycle */
+#endif
+
+#ifdef __alcd_Arena_Enable
+alcd_arena_t __alcd_arena;               /**< Arena and pool usage, see alcd_arenaReport() */
+void *__alcd_arenaMemory[(__alcd_Arena_Size + sizeof(void *) - 1) / sizeof(void *)];  /**< Arena storage, pointer aligned */
+#endif
+
+#ifdef __alcd_History_Enable
+alcd_history_t __alcd_history;           /**< Recorder statistics, see alcd_historyDump() */
+uint8_t __alcd_histLast[__alcd_max_y][__alcd_max_x];  /**< Screen as of the last record */
+uint8_t __alcd_histQueue[__alcd_History_Queue];  /**< Records waiting for flash programming */
+volatile uint16_t __alcd_histIn = 0;     /**< Bytes queued (free running) */
+volatile uint16_t __alcd_histOut = 0;    /**< Bytes programmed (free running) */
+uint32_t __alcd_histHead = 0;            /**< Ring offset where the next queued record will land */
+uint32_t __alcd_histWrite = 0;           /**< Ring offset of the next half-word to program */
+uint16_t __alcd_histRemain = 0;          /**< Bytes of the record being programmed */
+uint32_t __alcd_histSeq = 0;             /**< Sequence number of the next key frame */
+uint8_t __alcd_histKeyType = __alcd_History_Boot;  /**< Pending key frame type, 0 = deltas allowed */
+#endif
+
+#ifdef __alcd_Energy_Enable
+alcd_energy_t __alcd_energy = { .dim = 100 };  /**< Energy estimate and policy state */
+alcd_stats_t __alcd_energyBase;          /**< Counters at the start of the energy window */
+uint32_t __alcd_energyTick = 0;          /**< Tick at the start of the energy window */
+uint32_t __alcd_energyBLms = 0;          /**< Backlight ON time in the window, weighted by dim level (percent * ms) */
+uint32_t __alcd_energyBLTick = 0;        /**< Tick of the last backlight accounting */
+bool __alcd_energyBL = false;            /**< Backlight state as last set by alcd_backLight() */
+#endif
+
+alcd_vlcd_t __alcd_vlcd =                /**< Controller mirror, layout documented in alcd.h */
+{
+    .magic          = __alcd_vlcd_Magic,
+    .version        = __alcd_vlcd_Version,
+    .size           = sizeof(alcd_vlcd_t),
+    .entryMode      = __alcd_Entry_Inc,
+    .displayControl = __alcd_Display_OFF,
+};
+
+
+/* ============================================================================
+ *                       TIMING AND STATISTICS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Busy-wait for the given time and account it
+ * @param _us: Delay in microseconds
+ * @retval None
+ * @note All driver delays go through this function so that the
+ *       statistics module can report total busy-wait time
+ * ------------------------------------------------------- */
+static void __alcd_wait(uint32_t _us)
+{
+    #ifdef __alcd_Headless_Enable
+    if(!__alcd_present)                                            /**< No display: nothing to wait for */
+    {
+        return;
+    };
+    #endif
+    __alcd_statsCount(waitUs, _us);                                /**< Account busy-wait time */
+    __alcd_delay(_us);                                             /**< Blocking delay from aKaReZa library */
+};
+
+/* -------------------------------------------------------
+ * @brief Enable the DWT cycle counter
+ * @retval None
+ * @note Used by the statistics, governor and history modules
+ * ------------------------------------------------------- */
+static inline void __alcd_dwtEnable(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;                /**< Enable trace block for DWT */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;                           /**< Start cycle counter */
+};
+
+#ifdef __alcd_Stats_Enable
+/* -------------------------------------------------------
+ * @brief Reset bus and timing counters
+ * @retval None
+ * @note Also enables the DWT cycle counter used for busyCycles
+ *       Call at the start of a measurement window, read __alcd_stats
+ *       at its end (directly or from the debugger)
+ * ------------------------------------------------------- */
+void alcd_statsReset(void)
+{
+    __alcd_dwtEnable();                                            /**< Cycle counter for busyCycles */
+    memset(&__alcd_stats, 0, sizeof(__alcd_stats));                /**< Clear all counters */
+    #ifdef __alcd_Energy_Enable
+    memset(&__alcd_energyBase, 0, sizeof(__alcd_energyBase));      /**< Keep the energy window consistent */
+    #endif
+};
+#endif
+
+#ifdef __alcd_Profile_Enable
+/* -------------------------------------------------------
+ * @brief Charge following bus costs to a screen or widget ID
+ * @param _alcd_id: Application defined ID, 0 = untagged
+ * @retval ID that was selected before, for nesting:
+ *         uint16_t _prev = alcd_tag(WIDGET_BATTERY); ...; alcd_tag(_prev);
+ * @note Call from the main context. A new ID takes the next free slot;
+ *       with the table full the costs go to slot 0 (overflow counted)
+ * ------------------------------------------------------- */
+uint16_t alcd_tag(uint16_t _alcd_id)
+{
+    uint16_t _previous = __alcd_profile.tag[__alcd_profile.current].id;  /**< Returned for nesting */
+    uint8_t _slot = 0;                                             /**< Slot search index */
+
+    for(_slot = 0; _slot < __alcd_profile.count; _slot++)
+    {
+        if(__alcd_profile.tag[_slot].id == _alcd_id)
+        {
+            break;
+        };
+    };
+
+    if(_slot == __alcd_profile.count)                              /**< First use of this ID */
+    {
+        if(_slot < __alcd_Profile_Tags)
+        {
+            __alcd_profile.tag[_slot].id = _alcd_id;
+            __alcd_profile.count++;
+        }
+        else
+        {
+            _slot = 0;
+            __alcd_profile.overflow++;
+        };
+    };
+
+    __alcd_profile.current = _slot;
+    return _previous;
+};
+
+/* -------------------------------------------------------
+ * @brief Clear all tag costs
+ * @retval None
+ * @note Tags are forgotten; the current tag is selected again so
+ *       costs keep their owner. Cells keep no owner until rewritten
+ * ------------------------------------------------------- */
+void alcd_profileReset(void)
+{
+    uint16_t _id = __alcd_profile.tag[__alcd_profile.current].id;  /**< Tag to keep selected */
+
+    __alcd_dwtEnable();                                            /**< Cycle counter for busyCycles and flushCycles */
+    memset(&__alcd_profile, 0, sizeof(__alcd_profile));
+    memset(__alcd_tagOwner, 0, sizeof(__alcd_tagOwner));
+    __alcd_profile.count = 1;
+    alcd_tag(_id);
+};
+
+/* -------------------------------------------------------
+ * @brief Print the tags ranked by bus cost
+ * @retval None
+ * @note Ranked by CPU cycles blocked in alcd_write() under the tag.
+ *       One line per tag, e.g.
+ *       #1 tag 12  cmd 40 data 212 wait 12600us busy 907200cy 61% flush 0/0cy
+ * ------------------------------------------------------- */
+void alcd_profileReport(void)
+{
+    uint8_t _rank[__alcd_Profile_Tags];                            /**< Slots ordered by cost */
+    uint8_t _index = 0, _next = 0, _swap = 0;                      /**< Sort counters */
+    uint32_t _total = 0;                                           /**< Busy cycles of all tags */
+    const alcd_tagCost_t *_tag = NULL;                             /**< Tag being printed */
+
+    for(_index = 0; _index < __alcd_profile.count; _index++)
+    {
+        _rank[_index] = _index;
+        _total += __alcd_profile.tag[_index].bus.busyCycles;
+    };
+
+    for(_index = 0; _index + 1 < __alcd_profile.count; _index++)   /**< Selection sort, table is small */
+    {
+        for(_next = _index + 1; _next < __alcd_profile.count; _next++)
+        {
+            if(__alcd_profile.tag[_rank[_next]].bus.busyCycles > __alcd_profile.tag[_rank[_index]].bus.busyCycles)
+            {
+                _swap = _rank[_index];
+                _rank[_index] = _rank[_next];
+                _rank[_next] = _swap;
+            };
+        };
+    };
+
+    for(_index = 0; _index < __alcd_profile.count; _index++)
+    {
+        _tag = &__alcd_profile.tag[_rank[_index]];
+        printf("#%u tag %u  cmd %lu data %lu wait %luus busy %lucy %lu%% flush %lu/%lucy\r\n",
+               _index + 1, _tag->id, (unsigned long)_tag->bus.commands, (unsigned long)_tag->bus.data,
+               (unsigned long)_tag->bus.waitUs, (unsigned long)_tag->bus.busyCycles,
+               (unsigned long)(_total ? (uint64_t)_tag->bus.busyCycles * 100U / _total : 0),
+               (unsigned long)_tag->flushes, (unsigned long)_tag->flushCycles);
+    };
+    if(__alcd_profile.overflow)
+    {
+        printf("tag table full %lu times, charged to tag 0\r\n", (unsigned long)__alcd_profile.overflow);
+    };
+};
+#endif
+
+#ifdef __alcd_Timing_Enable
+/* -------------------------------------------------------
+ * @brief Convert timer ticks to ns
+ * @param _ticks: Interval in timer ticks
+ * @retval Interval in ns
+ * @note Works for any timer frequency, not only whole MHz
+ * ------------------------------------------------------- */
+static uint64_t __alcd_timingNs(uint32_t _ticks)
+{
+    return (uint64_t)_ticks * 1000000000ULL / __alcd_Timing_TimerHz;
+};
+
+/* -------------------------------------------------------
+ * @brief Add one interval to a timing statistic
+ * @param _stat: Statistic to update
+ * @param _ticks: Interval in timer ticks
+ * @param _minNs: Profile minimum in ns
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_timingAdd(alcd_timingStat_t *_stat, uint32_t _ticks, uint32_t _minNs)
+{
+    if(_stat->count == 0 || _ticks < _stat->min)
+    {
+        _stat->min = _ticks;
+    };
+    if(_ticks > _stat->max)
+    {
+        _stat->max = _ticks;
+    };
+    _stat->sum += _ticks;
+    _stat->count++;
+
+    if(__alcd_timingNs(_ticks) < _minNs)
+    {
+        __alcd_timing.violations++;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Clear the EN timing measurements
+ * @retval None
+ * @note Call before the workload to be verified
+ * ------------------------------------------------------- */
+void alcd_timingReset(void)
+{
+    memset(&__alcd_timing, 0, sizeof(__alcd_timing));
+    __alcd_timingHigh = false;
+    __alcd_timingBurst = false;
+};
+
+/* -------------------------------------------------------
+ * @brief Feed one captured EN edge
+ * @param _stamp: Captured counter value (HAL_TIM_ReadCapturedValue)
+ * @param _rising: true for the rising edge, false for the falling edge
+ * @retval None
+ * @note Call from HAL_TIM_IC_CaptureCallback(). The capture register
+ *       holds the exact edge time, so interrupt latency does not affect
+ *       the result as long as it is shorter than the EN high time.
+ * ------------------------------------------------------- */
+void alcd_timingEdge(uint32_t _stamp, bool _rising)
+{
+    uint32_t _now = HAL_GetTick();                                 /**< For counter wrap detection */
+
+    if(_rising)
+    {
+        if(__alcd_timingBurst && (_now - __alcd_timingRiseTick) < ((__alcd_Timing_Mask + 1UL) * 1000UL / __alcd_Timing_TimerHz))
+        {
+            __alcd_timingAdd(&__alcd_timing.cycle, (_stamp - __alcd_timingRise) & __alcd_Timing_Mask, __alcd_Timing_MinCycle);
+        };
+        __alcd_timingRise = _stamp;
+        __alcd_timingRiseTick = _now;
+        __alcd_timingHigh = true;
+        __alcd_timingBurst = true;
+    }
+    else if(__alcd_timingHigh)                                     /**< Falling edge of a seen pulse */
+    {
+        __alcd_timingAdd(&__alcd_timing.pulse, (_stamp - __alcd_timingRise) & __alcd_Timing_Mask, __alcd_Timing_MinPulse);
+        __alcd_timingHigh = false;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Print EN timing min/avg/max against the profile minimums
+ * @retval true if no interval was below its minimum
+ * @note Output via printf(), e.g.
+ *       EN pulse  ns: min 50125 avg 50310 max 61250 (>= 450) n=1200 OK
+ * ------------------------------------------------------- */
+bool alcd_timingReport(void)
+{
+    const alcd_timingStat_t *_stats[2] = {&__alcd_timing.pulse, &__alcd_timing.cycle};  /**< Statistics to print */
+    const char *_names[2] = {"pulse", "cycle"};                    /**< Row labels */
+    const uint32_t _limits[2] = {__alcd_Timing_MinPulse, __alcd_Timing_MinCycle};  /**< Profile minimums in ns */
+    uint8_t _index = 0;                                            /**< Row counter */
+
+    for(_index = 0; _index < 2; _index++)
+    {
+        const alcd_timingStat_t *_stat = _stats[_index];           /**< Current statistic */
+        uint32_t _avg = _stat->count ? (uint32_t)(_stat->sum / _stat->count) : 0;  /**< Average in ticks */
+
+        printf("EN %-6s ns: min %lu avg %lu max %lu (>= %lu) n=%lu %s\r\n", _names[_index],
+               (unsigned long)__alcd_timingNs(_stat->min), (unsigned long)__alcd_timingNs(_avg),
+               (unsigned long)__alcd_timingNs(_stat->max), (unsigned long)_limits[_index],
+               (unsigned long)_stat->count, (_stat->count && __alcd_timingNs(_stat->min) >= _limits[_index]) ? "OK" : "FAIL");
+    };
+    printf("Violations: %lu\r\n", (unsigned long)__alcd_timing.violations);
+
+    return __alcd_timing.violations == 0;
+};
+#endif
+
+#ifdef __alcd_Arena_Enable
+/* ============================================================================
+ *                       ARENA ALLOCATOR
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Carve a pool of fixed-size blocks out of the arena
+ * @param _name: Pool name for the report (kept by reference)
+ * @param _size: Block size in bytes (rounded up to the pointer size)
+ * @param _count: Number of blocks
+ * @retval Pool, or NULL if the arena or the pool table is full
+ * @note Call at startup; the arena space is never returned
+ * ------------------------------------------------------- */
+alcd_pool_t *alcd_poolCreate(const char *_name, uint16_t _size, uint16_t _count)
+{
+    alcd_pool_t *_pool = NULL;                                     /**< New pool descriptor */
+    uint32_t _blockSize = (_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);  /**< Room for the free-list link, pointer aligned */
+    uint16_t _index = 0;                                           /**< Block counter */
+
+    if(_size == 0 || _count == 0 || __alcd_arena.count >= __alcd_Arena_Pools || _blockSize > 0xFFFF ||
+       _blockSize * _count > sizeof(__alcd_arenaMemory) - __alcd_arena.used)
+    {
+        return NULL;
+    };
+
+    _pool = &__alcd_arena.pool[__alcd_arena.count++];
+    _pool->name = _name;
+    _pool->base = (uint8_t *)__alcd_arenaMemory + __alcd_arena.used;
+    _pool->blockSize = (uint16_t)_blockSize;
+    _pool->blocks = _count;
+    _pool->used = 0;
+    _pool->highWater = 0;
+    _pool->failed = 0;
+    __alcd_arena.used += _blockSize * _count;
+
+    _pool->free = NULL;
+    for(_index = _count; _index > 0; _index--)                     /**< Link blocks, lowest address first */
+    {
+        void *_block = _pool->base + (uint32_t)(_index - 1) * _blockSize;
+        *(void **)_block = _pool->free;
+        _pool->free = _block;
+    };
+
+    return _pool;
+};
+
+/* -------------------------------------------------------
+ * @brief Allocate one block
+ * @param _pool: Pool from alcd_poolCreate()
+ * @retval Block, or NULL if the pool is empty
+ * @note O(1), safe to call from an interrupt. The block content is
+ *       not cleared.
+ * ------------------------------------------------------- */
+void *alcd_poolAlloc(alcd_pool_t *_pool)
+{
+    void *_block = NULL;                                           /**< Block taken from the free list */
+    uint32_t _primask = __get_PRIMASK();                           /**< Restore the caller's interrupt state */
+
+    __disable_irq();
+    _block = _pool->free;
+    if(_block != NULL)
+    {
+        _pool->free = *(void **)_block;
+        _pool->used++;
+        if(_pool->used > _pool->highWater)
+        {
+            _pool->highWater = _pool->used;
+        };
+    }
+    else
+    {
+        _pool->failed++;
+    };
+    __set_PRIMASK(_primask);
+
+    return _block;
+};
+
+/* -------------------------------------------------------
+ * @brief Return a block to its pool
+ * @param _pool: Pool the block was allocated from
+ * @param _block: Block from alcd_poolAlloc(), NULL is ignored
+ * @retval None
+ * @note O(1), safe to call from an interrupt. Pointers outside the
+ *       pool are ignored; freeing a block twice is not detected.
+ * ------------------------------------------------------- */
+void alcd_poolFree(alcd_pool_t *_pool, void *_block)
+{
+    uint32_t _primask = 0;                                         /**< Restore the caller's interrupt state */
+    uint32_t _offset = (uint32_t)((uint8_t *)_block - _pool->base);  /**< Block offset in the pool */
+
+    if(_block == NULL || (uint8_t *)_block < _pool->base ||
+       _offset >= (uint32_t)_pool->blockSize * _pool->blocks || (_offset % _pool->blockSize) != 0)
+    {
+        return;
+    };
+
+    _primask = __get_PRIMASK();
+    __disable_irq();
+    *(void **)_block = _pool->free;
+    _pool->free = _block;
+    _pool->used--;
+    __set_PRIMASK(_primask);
+};
+
+/* -------------------------------------------------------
+ * @brief Print arena use and per-pool high-water marks
+ * @retval None
+ * @note Output via printf(), e.g.
+ *       Arena: 608/1024 bytes, 2/8 pools
+ *         layer    block   36 x 8    used 2    peak 5    failed 0
+ * ------------------------------------------------------- */
+void alcd_arenaReport(void)
+{
+    uint8_t _index = 0;                                            /**< Pool counter */
+
+    printf("Arena: %lu/%lu bytes, %u/%u pools\r\n", (unsigned long)__alcd_arena.used,
+           (unsigned long)sizeof(__alcd_arenaMemory), __alcd_arena.count, __alcd_Arena_Pools);
+    for(_index = 0; _index < __alcd_arena.count; _index++)
+    {
+        const alcd_pool_t *_pool = &__alcd_arena.pool[_index];     /**< Current pool */
+
+        printf("  %-8s block %4u x %-4u used %-4u peak %-4u failed %u\r\n", _pool->name ? _pool->name : "?",
+               _pool->blockSize, _pool->blocks, _pool->used, _pool->highWater, _pool->failed);
+    };
+};
+#endif
+
+#ifdef __alcd_History_Enable
+/* ============================================================================
+ *                       DISPLAY HISTORY RECORDER
+ * ============================================================================ */
+#define __alcd_histRing   ((uint32_t)__alcd_History_Pages * __alcd_History_PageSize)  /**< Ring size in bytes */
+
+/* -------------------------------------------------------
+ * @brief Timestamp of history records
+ * @retval HAL tick in ms
+ * @note Override to stamp records with RTC time, e.g. seconds since
+ *       epoch from the RTC counter
+ * ------------------------------------------------------- */
+__weak uint32_t alcd_historyTime(void)
+{
+    return HAL_GetTick();
+};
+
+/* -------------------------------------------------------
+ * @brief Ring offset where a record of the given size is stored
+ * @param _offset: Next free ring offset
+ * @param _length: Record size
+ * @retval Offset of the record
+ * @note Records never straddle a page: a record that does not fit
+ *       the rest of the page starts the next one
+ * ------------------------------------------------------- */
+static uint32_t __alcd_histPlace(uint32_t _offset, uint8_t _length)
+{
+    if((_offset % __alcd_History_PageSize) + _length > __alcd_History_PageSize)
+    {
+        _offset = ((_offset / __alcd_History_PageSize + 1) * __alcd_History_PageSize) % __alcd_histRing;
+    };
+    return _offset;
+};
+
+/* -------------------------------------------------------
+ * @brief Build a key frame record of the current screen
+ * @param _record: Record buffer (__alcd_History_KeySize bytes)
+ * @param _type: __alcd_History_Key or __alcd_History_Boot
+ * @param _time: Timestamp
+ * @retval Record size
+ * ------------------------------------------------------- */
+static uint8_t __alcd_histKey(uint8_t *_record, uint8_t _type, uint32_t _time)
+{
+    _record[0] = __alcd_History_KeySize;
+    _record[1] = _type;
+    memcpy(&_record[2], &_time, 4);
+    memcpy(&_record[6], &__alcd_histSeq, 4);
+    memcpy(&_record[10], __alcd_fb, sizeof(__alcd_fb));
+    if(sizeof(__alcd_fb) & 1)
+    {
+        _record[__alcd_History_KeySize - 1] = 0xFF;                /**< Pad to an even length */
+    };
+    return __alcd_History_KeySize;
+};
+
+/* -------------------------------------------------------
+ * @brief Queue the screen changes since the last record
+ * @retval None
+ * @note Called at the end of alcd_flush(). One pass over the cells
+ *       plus a copy into the queue; flash is only touched by
+ *       alcd_historyTask()
+ * ------------------------------------------------------- */
+static void __alcd_historyRecord(void)
+{
+    uint32_t _startCycles = DWT->CYCCNT;                           /**< Recording overhead measurement */
+    const uint8_t *_cells = &__alcd_fb[0][0];                      /**< Framebuffer as linear cell array */
+    const uint8_t *_last = &__alcd_histLast[0][0];                 /**< Last recorded screen */
+    uint8_t _record[__alcd_History_KeySize + 4];                   /**< Record being built (+ one run and pad past a key) */
+    uint8_t _length = 6, _run = 0;                                 /**< Record size, position of the open run */
+    uint32_t _time = alcd_historyTime();                           /**< Record timestamp */
+    uint32_t _offset = 0;                                          /**< Ring offset of the record */
+    uint16_t _cell = 0, _index = 0;                                /**< Cell and copy counters */
+    bool _open = false;                                            /**< A run is being extended */
+
+    if(__alcd_history.flashErrors != 0)                            /**< Flash failed: recording stopped */
+    {
+        return;
+    };
+
+    for(_cell = 0; _cell < sizeof(__alcd_fb) && _length <= __alcd_History_KeySize; _cell++)
+    {
+        if(_cells[_cell] == _last[_cell])
+        {
+            _open = false;
+            continue;
+        };
+        if(!_open)                                                 /**< Start a new run */
+        {
+            _run = _length;
+            _record[_length++] = _cell;
+            _record[_length++] = 0;
+            _open = true;
+        };
+        _record[_run + 1]++;
+        _record[_length++] = _cells[_cell];
+    };
+
+    if(_length == 6 && __alcd_histKeyType == 0)                    /**< Screen unchanged */
+    {
+        return;
+    };
+
+    if(_length & 1)
+    {
+        _record[_length++] = 0xFF;                                 /**< Pad: 0xFF is no valid run position */
+    };
+    _offset = __alcd_histPlace(__alcd_histHead, _length);
+    if(__alcd_histKeyType != 0 || _length > __alcd_History_KeySize || (_offset % __alcd_History_PageSize) == 0)
+    {
+        _length = __alcd_histKey(_record, __alcd_histKeyType ? __alcd_histKeyType : __alcd_History_Key, _time);
+        _offset = __alcd_histPlace(__alcd_histHead, _length);
+    }
+    else
+    {
+        _record[0] = _length;
+        _record[1] = __alcd_History_Delta;
+        memcpy(&_record[2], &_time, 4);
+    };
+
+    if((uint16_t)(__alcd_histIn - __alcd_histOut) + _length > __alcd_History_Queue)  /**< Queue full: lose this record */
+    {
+        __alcd_history.dropped++;
+        __alcd_histKeyType = __alcd_History_Key;                   /**< Resynchronize with a key frame */
+        return;
+    };
+
+    for(_index = 0; _index < _length; _index++)
+    {
+        __alcd_histQueue[(uint16_t)(__alcd_histIn + _index) % __alcd_History_Queue] = _record[_index];
+    };
+    __DMB();                                                       /**< Record complete before it is published */
+    __alcd_histIn += _length;
+    __alcd_histHead = (_offset + _length) % __alcd_histRing;
+    __alcd_histKeyType = 0;
+    memcpy(__alcd_histLast, __alcd_fb, sizeof(__alcd_fb));
+
+    if(_record[1] != __alcd_History_Delta)
+    {
+        __alcd_histSeq++;                                          /**< Sequence counts queued key frames only */
+        __alcd_history.keys++;
+    };
+    __alcd_history.records++;
+    __alcd_history.bytes += _length;
+    __alcd_history.cycles = DWT->CYCCNT - _startCycles;
+    if(__alcd_history.cycles > __alcd_history.cyclesMax)
+    {
+        __alcd_history.cyclesMax = __alcd_history.cycles;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Find the end of the recorded history after reset
+ * @retval None
+ * @note The newest page is the one whose first key frame has the
+ *       highest sequence number. Recording continues after its last
+ *       record, starting with a 'B' key frame.
+ * ------------------------------------------------------- */
+static void __alcd_historyStart(void)
+{
+    const uint8_t *_page = NULL;                                   /**< Page being examined */
+    uint32_t _seq = 0, _best = 0, _offset = 0;                     /**< Sequence numbers, offset in the page */
+    int8_t _newest = -1;                                           /**< Newest page, -1 = empty ring */
+    uint8_t _index = 0;                                            /**< Page counter */
+
+    __alcd_dwtEnable();                                            /**< Cycle counter for the overhead figures */
+    for(_index = 0; _index < __alcd_History_Pages; _index++)
+    {
+        _page = (const uint8_t *)(uintptr_t)(__alcd_History_Start + (uint32_t)_index * __alcd_History_PageSize);
+        if(_page[0] == __alcd_History_KeySize && (_page[1] == __alcd_History_Key || _page[1] == __alcd_History_Boot))
+        {
+            memcpy(&_seq, &_page[6], 4);
+            if(_newest < 0 || (int32_t)(_seq - _best) > 0)
+            {
+                _newest = _index;
+                _best = _seq;
+            };
+        };
+    };
+
+    __alcd_histHead = 0;
+    __alcd_histSeq = 0;
+    if(_newest >= 0)
+    {
+        _page = (const uint8_t *)(uintptr_t)(__alcd_History_Start + (uint32_t)_newest * __alcd_History_PageSize);
+        while(_offset + 6 <= __alcd_History_PageSize && _page[_offset] >= 6 && _page[_offset] != 0xFF &&
+              _offset + _page[_offset] <= __alcd_History_PageSize)
+        {
+            if(_page[_offset + 1] != __alcd_History_Delta)         /**< Key frames carry the sequence */
+            {
+                memcpy(&_seq, &_page[_offset + 6], 4);
+                _best = ((int32_t)(_seq - _best) > 0) ? _seq : _best;
+            };
+            _offset += _page[_offset];
+        };
+        __alcd_histHead = ((uint32_t)_newest * __alcd_History_PageSize + _offset) % __alcd_histRing;
+        __alcd_histSeq = _best + 1;
+    };
+
+    __alcd_histWrite = __alcd_histHead;
+    __alcd_histRemain = 0;
+    __alcd_histOut = __alcd_histIn;
+    __alcd_histKeyType = __alcd_History_Boot;
+};
+
+/* -------------------------------------------------------
+ * @brief Program queued history records into flash
+ * @retval None
+ * @note Call from the main loop. Programs at most
+ *       __alcd_History_Burst half-words per call (about 60 us each);
+ *       entering a page erases it first (20-40 ms on the F103), once
+ *       per page. The F103 has a single flash bank: every instruction
+ *       fetch from flash stalls while it is busy, interrupt handlers
+ *       included, so RTC, CAN and Modbus interrupts are delayed by up
+ *       to the full erase time. Handlers that cannot wait must run
+ *       from RAM, with their vector table relocated to RAM.
+ *       A failed erase or program is counted in
+ *       __alcd_history.flashErrors and stops recording until reset;
+ *       the write offset is not advanced past the failed half-word
+ * ------------------------------------------------------- */
+void alcd_historyTask(void)
+{
+    FLASH_EraseInitTypeDef _erase = {0};                           /**< Page erase request */
+    uint32_t _error = 0;                                           /**< Failing page from HAL_FLASHEx_Erase */
+    uint16_t _halfWord = 0, _count = 0;                            /**< Value to program, half-words done */
+
+    if(__alcd_histIn == __alcd_histOut || __alcd_history.flashErrors != 0)
+    {
+        return;
+    };
+
+    HAL_FLASH_Unlock();
+    for(_count = 0; _count < __alcd_History_Burst && __alcd_histIn != __alcd_histOut; _count++)
+    {
+        if(__alcd_histRemain == 0)                                 /**< Start of a record */
+        {
+            __alcd_histRemain = __alcd_histQueue[__alcd_histOut % __alcd_History_Queue];
+            __alcd_histWrite = __alcd_histPlace(__alcd_histWrite, __alcd_histRemain);
+            if((__alcd_histWrite % __alcd_History_PageSize) == 0)  /**< New page: drop the oldest history */
+            {
+                _erase.TypeErase = FLASH_TYPEERASE_PAGES;
+                _erase.Banks = FLASH_BANK_1;
+                _erase.PageAddress = __alcd_History_Start + __alcd_histWrite;
+                _erase.NbPages = 1;
+                if(HAL_FLASHEx_Erase(&_erase, &_error) != HAL_OK)  /**< Page not erased: stop recording */
+                {
+                    __alcd_history.flashErrors++;
+                    break;
+                };
+            };
+        };
+
+        _halfWord = __alcd_histQueue[__alcd_histOut % __alcd_History_Queue] |
+                    (__alcd_histQueue[(uint16_t)(__alcd_histOut + 1) % __alcd_History_Queue] << 8);
+        if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, __alcd_History_Start + __alcd_histWrite, _halfWord) != HAL_OK)
+        {
+            __alcd_history.flashErrors++;                          /**< Half-word not programmed: stop recording */
+            break;
+        };
+        __alcd_histOut += 2;
+        __alcd_histWrite = (__alcd_histWrite + 2) % __alcd_histRing;
+        __alcd_histRemain -= 2;
+    };
+    HAL_FLASH_Lock();
+};
+
+/* -------------------------------------------------------
+ * @brief Print all history records oldest first
+ * @retval None
+ * @note Programs the queue first. One "H <hex>" line per record,
+ *       followed by a "#" statistics line, e.g.
+ *       H 2A42E8030000000000002020...
+ *       # records 120 keys 3 dropped 0 bytes 1532 cycles 410 max 1190 flash errors 0
+ * ------------------------------------------------------- */
+void alcd_historyDump(void)
+{
+    const uint8_t *_page = NULL;                                   /**< Page being printed */
+    uint32_t _offset = 0;                                          /**< Record offset in the page */
+    uint8_t _index = 0, _byte = 0;                                 /**< Page and byte counters */
+
+    while(__alcd_histIn != __alcd_histOut && __alcd_history.flashErrors == 0)
+    {
+        alcd_historyTask();
+    };
+
+    for(_index = 1; _index <= __alcd_History_Pages; _index++)      /**< Page after the current one is the oldest */
+    {
+        _page = (const uint8_t *)(uintptr_t)(__alcd_History_Start +
+                ((__alcd_histWrite / __alcd_History_PageSize + _index) % __alcd_History_Pages) * __alcd_History_PageSize);
+        for(_offset = 0; _offset + 6 <= __alcd_History_PageSize && _page[_offset] >= 6 && _page[_offset] != 0xFF &&
+            _offset + _page[_offset] <= __alcd_History_PageSize; _offset += _page[_offset])
+        {
+            printf("H ");
+            for(_byte = 0; _byte < _page[_offset]; _byte++)
+            {
+                printf("%02X", _page[_offset + _byte]);
+            };
+            printf("\r\n");
+        };
+    };
+    printf("# records %lu keys %lu dropped %lu bytes %lu cycles %lu max %lu flash errors %lu\r\n",
+           (unsigned long)__alcd_history.records, (unsigned long)__alcd_history.keys, (unsigned long)__alcd_history.dropped,
+           (unsigned long)__alcd_history.bytes, (unsigned long)__alcd_history.cycles, (unsigned long)__alcd_history.cyclesMax,
+           (unsigned long)__alcd_history.flashErrors);
+};
+#endif
+
+#ifdef __alcd_Energy_Enable
+/* -------------------------------------------------------
+ * @brief Estimate bus energy between two counter snapshots
+ * @param _from: Earlier counters
+ * @param _to: Later counters
+ * @retval Energy in nJ
+ * @note Computed in 64 bits: a long window or larger coefficients
+ *       exceed 4.29 J (2^32 nJ), e.g. 43 s of busy-waiting at 100 mW
+ * ------------------------------------------------------- */
+static uint64_t __alcd_energyBus(const alcd_stats_t *_from, const alcd_stats_t *_to)
+{
+    return (uint64_t)(_to->enPulses - _from->enPulses) * __alcd_Energy_EnPulse
+         + ((uint64_t)(_to->commands - _from->commands) + (_to->data - _from->data)) * __alcd_Energy_Byte
+         + (uint64_t)(_to->waitUs - _from->waitUs) * __alcd_Energy_CpuPower;  /**< mW * us = nJ */
+};
+
+/* -------------------------------------------------------
+ * @brief Saturate a 64-bit energy or power value to 32 bits
+ * @param _value: Value to store
+ * @retval _value, or UINT32_MAX if it does not fit
+ * ------------------------------------------------------- */
+static uint32_t __alcd_energyClip(uint64_t _value)
+{
+    return (_value > UINT32_MAX) ? UINT32_MAX : (uint32_t)_value;
+};
+
+/* -------------------------------------------------------
+ * @brief Accumulate backlight ON time up to now
+ * @retval None
+ * @note Called before every backlight state or dim level change
+ * ------------------------------------------------------- */
+static void __alcd_energyBacklight(void)
+{
+    uint32_t _now = HAL_GetTick();                                 /**< Current tick in ms */
+
+    if(__alcd_energyBL)
+    {
+        __alcd_energyBLms += (_now - __alcd_energyBLTick) * __alcd_energy.dim;
+    };
+    __alcd_energyBLTick = _now;
+};
+
+/* -------------------------------------------------------
+ * @brief Backlight dimming callback
+ * @param _percent: Requested backlight level in percent
+ * @retval Level actually applied in percent
+ * @note Default implementation cannot dim a GPIO backlight and returns
+ *       100. Override with a PWM implementation, e.g.
+ *       __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1, _percent); return _percent;
+ * ------------------------------------------------------- */
+__weak uint8_t alcd_energyDimCallback(uint8_t _percent)
+{
+    UNUSED(_percent);
+    return 100;
+};
+
+/* -------------------------------------------------------
+ * @brief Evaluate the power budget and adjust the policy level
+ * @retval None
+ * @note Call from the main loop; alcd_task() calls it when the governor
+ *       is enabled. Every __alcd_Energy_Window ms the average bus and
+ *       backlight power are computed into __alcd_energy and the policy
+ *       level moves one step towards the budget (see alcd.h).
+ * ------------------------------------------------------- */
+void alcd_energyTask(void)
+{
+    uint32_t _now = HAL_GetTick();                                 /**< Current tick in ms */
+    uint32_t _window = _now - __alcd_energyTick;                   /**< Elapsed window in ms */
+    alcd_stats_t _stats = __alcd_stats;                            /**< Counters at the end of the window */
+    uint8_t _dim = 0;                                              /**< Backlight level for the new policy level */
+
+    if(_window < __alcd_Energy_Window)
+    {
+        return;
+    };
+
+    __alcd_energyBacklight();
+    __alcd_energy.busUw = __alcd_energyClip(__alcd_energyBus(&__alcd_energyBase, &_stats) / _window);  /**< nJ / ms = uW */
+    __alcd_energy.backlightUw = __alcd_energyClip((uint64_t)__alcd_energyBLms * __alcd_Energy_BLPower * 10 / _window);  /**< percent * ms * mW -> uW */
+    __alcd_energy.totalUw = __alcd_energyClip((uint64_t)__alcd_energy.busUw + __alcd_energy.backlightUw);
+    __alcd_energy.backlightDuty = (__alcd_energy.dim != 0) ? __alcd_energyBLms / __alcd_energy.dim * 100 / _window : 0;
+
+    __alcd_energyBase = _stats;                                    /**< Start next window */
+    __alcd_energyTick = _now;
+    __alcd_energyBLms = 0;
+
+    if(__alcd_energy.totalUw > __alcd_Energy_Budget * 1000UL && __alcd_energy.level < __alcd_Energy_Levels)
+    {
+        __alcd_energy.level++;                                     /**< Over budget: one step more saving */
+    }
+    else if(__alcd_energy.totalUw < __alcd_Energy_Budget * 800UL && __alcd_energy.level > 0)
+    {
+        __alcd_energy.level--;                                     /**< Below 80% of budget: one step back */
+    };
+
+    _dim = (__alcd_energy.level >= 3) ? (100 >> (__alcd_energy.level - 2)) : 100;
+    if(_dim != __alcd_energy.dim && __alcd_energyBL)
+    {
+        __alcd_energy.dim = alcd_energyDimCallback(_dim);
+    };
+};
+#endif
+
+
+#ifdef __alcd_Serial_Enable
+/* ============================================================================
+ *                       SERIAL CONTROLLER BACKEND
+ * ============================================================================ */
+#ifdef __alcd_Serial_I2C
+extern I2C_HandleTypeDef __alcd_Serial_I2C;
+
+/* -------------------------------------------------------
+ * @brief Start an I2C transaction
+ * @param _data: Control and data bytes
+ * @param _length: Number of bytes
+ * @retval true if the DMA transfer was started
+ * @note Completion is reported through alcd_serialTxDone()
+ * ------------------------------------------------------- */
+bool alcd_serialTransmit(const uint8_t *_data, uint16_t _length)
+{
+    return HAL_I2C_Master_Transmit_DMA(&__alcd_Serial_I2C, __alcd_Serial_Address, (uint8_t *)_data, _length) == HAL_OK;
+};
+
+/* -------------------------------------------------------
+ * @brief Abort the transaction in flight
+ * @retval true if the DMA no longer reads __alcd_serialBuffer
+ * @note On the F1 the DMA channel is disabled before
+ *       HAL_I2C_Master_Abort_IT() returns; the I2C side (STOP,
+ *       handle state) completes in the interrupt
+ * ------------------------------------------------------- */
+bool alcd_serialAbort(void)
+{
+    return HAL_I2C_Master_Abort_IT(&__alcd_Serial_I2C, __alcd_Serial_Address) == HAL_OK;
+};
+#else
+/* -------------------------------------------------------
+ * @brief Abort the transaction in flight
+ * @retval true if the transport no longer reads __alcd_serialBuffer
+ * @note Default for a user transport: cannot abort, so the next
+ *       transaction is dropped while the previous one is pending.
+ *       Override together with alcd_serialTransmit().
+ * ------------------------------------------------------- */
+__weak bool alcd_serialAbort(void)
+{
+    return false;
+};
+#endif
+
+/* -------------------------------------------------------
+ * @brief Transaction complete
+ * @retval None
+ * @note Call from HAL_I2C_MasterTxCpltCallback() and
+ *       HAL_I2C_ErrorCallback()
+ * ------------------------------------------------------- */
+void alcd_serialTxDone(void)
+{
+    __alcd_serialBusy = false;
+};
+
+/* -------------------------------------------------------
+ * @brief Wait until the previous transaction has completed
+ * @retval true if __alcd_serialBuffer may be refilled
+ * @note Gives up after __alcd_Serial_Timeout ms so a missing
+ *       callback or a hung bus cannot block the application.
+ *       The transfer is then aborted; if that fails the buffer
+ *       still belongs to the DMA and stays busy.
+ * ------------------------------------------------------- */
+static bool __alcd_serialWait(void)
+{
+    uint32_t _start = HAL_GetTick();                               /**< Timeout reference */
+
+    while(__alcd_serialBusy && (HAL_GetTick() - _start) < __alcd_Serial_Timeout);
+    if(__alcd_serialBusy && alcd_serialAbort())                    /**< Timed out: stop the DMA before reuse */
+    {
+        __alcd_serialBusy = false;
+    };
+    return !__alcd_serialBusy;
+};
+
+/* -------------------------------------------------------
+ * @brief Send the collected transaction
+ * @retval None
+ * @note The buffer holds one control byte per data byte, all with
+ *       Co=1. The last run of the same kind (RS) is rewritten as one
+ *       control byte with Co=0 followed by the bare bytes.
+ * ------------------------------------------------------- */
+static void __alcd_serialSend(void)
+{
+    uint16_t _run = 0, _index = 0, _out = 0;                       /**< Start of the final run, copy positions */
+
+    if(__alcd_serialLength == 0)
+    {
+        return;
+    };
+
+    _run = __alcd_serialLength - 2;                                /**< Last pair */
+    while(_run >= 2 && __alcd_serialBuffer[_run - 2] == __alcd_serialBuffer[__alcd_serialLength - 2])
+    {
+        _run -= 2;                                                 /**< Same control byte: same kind */
+    };
+    __alcd_serialBuffer[_run] &= ~__alcd_Serial_Co;                /**< Only data bytes follow */
+    for(_index = _run + 2, _out = _run + 2; _index < __alcd_serialLength; _index += 2)
+    {
+        __alcd_serialBuffer[_out++] = __alcd_serialBuffer[_index + 1];
+    };
+
+    __alcd_serialBusy = true;
+    if(!alcd_serialTransmit(__alcd_serialBuffer, _out))            /**< Bus error: drop the transaction */
+    {
+        __alcd_serialBusy = false;
+    };
+    __alcd_serialLength = 0;
+};
+
+/* -------------------------------------------------------
+ * @brief Add one command or data byte to the transaction
+ * @param _data: Byte to send
+ * @param _alcd_cmdData: Mode (false=Command, true=Data)
+ * @retval None
+ * @note Outside a burst the byte is sent at once. During init every
+ *       byte is its own transaction followed by the init delay, like
+ *       the strobes of the parallel bus.
+ * ------------------------------------------------------- */
+static void __alcd_serialPut(uint8_t _data, bool _alcd_cmdData)
+{
+    if(__alcd_serialDrop)                                          /**< Rest of a dropped transaction */
+    {
+        return;
+    };
+    if(__alcd_serialLength + 2 > __alcd_Serial_BufferSize)         /**< Burst larger than the buffer: split */
+    {
+        __alcd_serialSend();
+    };
+    if(__alcd_serialLength == 0 && !__alcd_serialWait())           /**< Buffer still owned by the DMA: drop */
+    {
+        __alcd_serialDropped++;
+        __alcd_serialDrop = (__alcd_serialDepth > 0);              /**< Skip the rest of the burst without waiting again */
+        return;
+    };
+
+    __alcd_serialBuffer[__alcd_serialLength++] = __alcd_Serial_Co | (_alcd_cmdData ? __alcd_Serial_RS : 0);
+    __alcd_serialBuffer[__alcd_serialLength++] = _data;
+
+    if(__alcd_serialDepth == 0)
+    {
+        __alcd_serialSend();
+    };
+    if(__alcd_initStatus == false)                                 /**< Init: slow, one byte at a time */
+    {
+        __alcd_serialWait();
+        __alcd_wait(__alcd_delay_modeSet);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Collect the following writes into one transaction
+ * @retval None
+ * @note Bursts nest; the transaction is sent by the outermost
+ *       __alcd_serialEnd()
+ * ------------------------------------------------------- */
+static void __alcd_serialBegin(void)
+{
+    __alcd_serialDepth++;
+};
+
+/* -------------------------------------------------------
+ * @brief Close a burst and send the transaction
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_serialEnd(void)
+{
+    if(__alcd_serialDepth > 0 && --__alcd_serialDepth == 0)
+    {
+        __alcd_serialSend();
+        __alcd_serialDrop = false;                                 /**< Next transaction tries again */
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Controller specific power-up sequence
+ * @retval None
+ * @note Sent around the controller mirror: extended instruction
+ *       sets reuse HD44780 opcodes with other meanings. The final
+ *       function set goes through alcd_write() so the mirror holds it.
+ * ------------------------------------------------------- */
+static void __alcd_serialInit(void)
+{
+    #if __alcd_Serial_Controller == __alcd_Ctrl_ST7032
+    const uint8_t _init[][2] =                                     /**< {RS, byte} */
+    {
+        {0, 0x38}, {0, 0x39},                                      /**< 8-bit, 2 lines, instruction table 1 */
+        {0, 0x14},                                                 /**< Internal OSC, bias 1/5 */
+        {0, 0x70 | (__alcd_Serial_Contrast & 0x0F)},               /**< Contrast low bits */
+        {0, 0x50 | (__alcd_Serial_Booster << 2) | ((__alcd_Serial_Contrast >> 4) & 0x03)},  /**< Booster, contrast high bits */
+        {0, 0x6C},                                                 /**< Follower on, amplifier ratio */
+    };
+    const uint8_t _functionSet = 0x38;                             /**< Back to instruction table 0 */
+    #elif __alcd_Serial_Controller == __alcd_Ctrl_AIP31068
+    const uint8_t _init[][2] =
+    {
+        {0, 0x38}, {0, 0x38}, {0, 0x38},                           /**< Function set repeated as for the HD44780 */
+    };
+    const uint8_t _functionSet = 0x38;
+    #elif __alcd_Serial_Controller == __alcd_Ctrl_US2066
+    const uint8_t _init[][2] =
+    {
+        {0, 0x2A}, {0, 0x71}, {1, __alcd_Serial_Regulator ? 0x5C : 0x00},  /**< RE=1: internal VDD regulator */
+        {0, 0x28}, {0, 0x08},                                      /**< RE=0: display off */
+        {0, 0x2A}, {0, 0x79}, {0, 0xD5}, {0, 0x70}, {0, 0x78},     /**< SD=1: oscillator frequency, SD=0 */
+        {0, 0x08},                                                 /**< Extended function set: 5-dot, 1/2 lines */
+        {0, 0x06},                                                 /**< COM/SEG scan direction */
+        {0, 0x72}, {1, 0x00},                                      /**< ROM A, 8 CGRAM characters */
+        {0, 0x2A}, {0, 0x79}, {0, 0xDA}, {0, 0x10},                /**< SEG pin configuration */
+        {0, 0xDC}, {0, 0x00},                                      /**< Internal VSL, GPIO off */
+        {0, 0x81}, {0, __alcd_Serial_Contrast},                    /**< Contrast */
+        {0, 0xD9}, {0, 0xF1}, {0, 0xDB}, {0, 0x40},                /**< Phase length, VCOMH level */
+        {0, 0x78},                                                 /**< SD=0 */
+    };
+    const uint8_t _functionSet = 0x28;                             /**< RE=0, 2 lines */
+    #else
+        #error "Unknown __alcd_Serial_Controller"
+    #endif
+    uint8_t _index = 0;                                            /**< Sequence counter */
+
+    __alcd_serialDepth = 0;
+    __alcd_serialLength = 0;
+    __alcd_serialDrop = false;
+    for(_index = 0; _index < sizeof(_init) / sizeof(_init[0]); _index++)
+    {
+        __alcd_serialPut(_init[_index][1], _init[_index][0]);
+    };
+    #if __alcd_Serial_Controller == __alcd_Ctrl_ST7032
+    __alcd_wait(200000);                                           /**< Booster/follower settling time */
+    #endif
+    alcd_write(_functionSet, __alcd_writeCmd);
+};
+#else
+    #define __alcd_serialBegin()   ((void)0)                       /**< Parallel bus: no transactions */
+    #define __alcd_serialEnd()     ((void)0)
+#endif
+
+
+/* ============================================================================
+ *                       CONTROLLER MIRROR FUNCTIONS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Move mirrored address counter by one position
+ * @param _increment: Direction (true=increment, false=decrement)
+ * @retval None
+ * @note DDRAM addressing follows 2-line mode: 0x27 is followed by 0x40
+ *       and 0x67 wraps back to 0x00. CGRAM wraps within 0x00-0x3F.
+ * ------------------------------------------------------- */
+static void __alcd_vlcdStep(bool _increment)
+{
+    uint8_t _line = (__alcd_vlcd.address >> 6) & 0x01;            /**< DDRAM line of current address */
+    uint8_t _column = __alcd_vlcd.address & 0x3F;                  /**< DDRAM column of current address */
+
+    if(__alcd_vlcd.cgramSelect)                                    /**< CGRAM address space */
+    {
+        __alcd_vlcd.address = (__alcd_vlcd.address + (_increment ? 1 : -1)) & 0x3F;
+        return;
+    };
+
+    if(_increment)
+    {
+        if(++_column >= __alcd_DDRAM_Columns)                      /**< End of line reached */
+        {
+            _column = 0;
+            _line ^= 0x01;                                         /**< Continue on the other line */
+        };
+    }
+    else
+    {
+        if(_column-- == 0)                                         /**< Start of line passed */
+        {
+            _column = __alcd_DDRAM_Columns - 1;
+            _line ^= 0x01;
+        };
+    };
+
+    __alcd_vlcd.address = (_line << 6) | _column;                  /**< Rebuild DDRAM address */
+};
+
+/* -------------------------------------------------------
+ * @brief Shift mirrored display window by one column
+ * @param _left: Shift direction (true=content moves left, false=right)
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_vlcdShift(bool _left)
+{
+    if(_left)
+    {
+        __alcd_vlcd.shift = (__alcd_vlcd.shift + 1) % __alcd_DDRAM_Columns;
+    }
+    else
+    {
+        __alcd_vlcd.shift = (__alcd_vlcd.shift + __alcd_DDRAM_Columns - 1) % __alcd_DDRAM_Columns;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Decode a command or data byte into the controller mirror
+ * @param _data: Byte sent to the LCD
+ * @param _alcd_cmdData: Mode (false=Command, true=Data)
+ * @retval None
+ * @note Called by alcd_write() for every byte, so __alcd_vlcd always
+ *       reflects what the controller holds. The sequence counter is odd
+ *       while the mirror is being modified (see alcd.h).
+ * ------------------------------------------------------- */
+static void __alcd_vlcdUpdate(uint8_t _data, bool _alcd_cmdData)
+{
+    uint8_t _line = 0;                                             /**< DDRAM line index */
+    uint8_t _column = 0;                                           /**< DDRAM column index */
+
+    #ifdef __alcd_Graphic_Enable
+    if(__alcd_gfxActive || (_alcd_cmdData == __alcd_writeCmd && (_data & __alcd_Gfx_ModeMask) == 0x13))
+    {
+        return;                                                    /**< Graphic addresses/data and mode commands are not DDRAM state */
+    };
+    #endif
+
+    __alcd_vlcd.sequence++;                                        /**< Odd: update in progress */
+    __DMB();                                                       /**< Mirror stores stay inside the odd window */
+
+    if(_alcd_cmdData == __alcd_writeData)                          /**< Data write to DDRAM or CGRAM */
+    {
+        if(__alcd_vlcd.cgramSelect)
+        {
+            __alcd_vlcd.cgram[__alcd_vlcd.address & 0x3F] = _data;
+        }
+        else
+        {
+            _line = (__alcd_vlcd.address >> 6) & 0x01;
+            _column = __alcd_vlcd.address & 0x3F;
+            if(_column < __alcd_DDRAM_Columns)                     /**< Ignore writes to unused addresses */
+            {
+                __alcd_vlcd.ddram[_line][_column] = _data;
+            };
+        };
+
+        __alcd_vlcdStep(bitCheck(__alcd_vlcd.entryMode, 1));       /**< I/D bit selects direction */
+        if(bitCheck(__alcd_vlcd.entryMode, 0) && !__alcd_vlcd.cgramSelect)  /**< S bit: shift display with write */
+        {
+            __alcd_vlcdShift(bitCheck(__alcd_vlcd.entryMode, 1));
+        };
+    }
+    else if(_data & 0x80)                                          /**< Set DDRAM address */
+    {
+        __alcd_vlcd.address = _data & 0x7F;
+        __alcd_vlcd.cgramSelect = 0;
+    }
+    else if(_data & 0x40)                                          /**< Set CGRAM address */
+    {
+        __alcd_vlcd.address = _data & 0x3F;
+        __alcd_vlcd.cgramSelect = 1;
+    }
+    else if(_data & 0x20)                                          /**< Function set */
+    {
+        __alcd_vlcd.functionSet = _data;
+    }
+    else if(_data & 0x10)                                          /**< Cursor or display shift */
+    {
+        if(bitCheck(_data, 3))                                     /**< S/C=1: display shift */
+        {
+            __alcd_vlcdShift(!bitCheck(_data, 2));                 /**< R/L=0: shift left */
+        }
+        else                                                       /**< S/C=0: cursor move */
+        {
+            __alcd_vlcdStep(bitCheck(_data, 2));                   /**< R/L=1: move right */
+        };
+    }
+    else if(_data & 0x08)                                          /**< Display ON/OFF control */
+    {
+        __alcd_vlcd.displayControl = _data;
+    }
+    else if(_data & 0x04)                                          /**< Entry mode set */
+    {
+        __alcd_vlcd.entryMode = _data;
+    }
+    else if(_data & 0x02)                                          /**< Return home */
+    {
+        __alcd_vlcd.address = 0x00;
+        __alcd_vlcd.cgramSelect = 0;
+        __alcd_vlcd.shift = 0;
+    }
+    else if(_data & 0x01)                                          /**< Clear display */
+    {
+        memset(__alcd_vlcd.ddram, ' ', sizeof(__alcd_vlcd.ddram)); /**< Controller fills DDRAM with spaces */
+        __alcd_vlcd.address = 0x00;
+        __alcd_vlcd.cgramSelect = 0;
+        __alcd_vlcd.shift = 0;
+        bitSet(__alcd_vlcd.entryMode, 1);                          /**< Clear also sets I/D=1 */
+    };
+
+    __DMB();                                                       /**< Complete the mirror stores before going even */
+    __alcd_vlcd.sequence++;                                        /**< Even: mirror consistent again */
+};
+
+/* -------------------------------------------------------
+ * @brief Copy a consistent snapshot of the controller mirror
+ * @param _alcd_copy: Destination for the snapshot
+ * @retval None
+ * @note Retries until the copy was taken without a concurrent update.
+ *       The guarantee holds for readers at the same or a lower priority
+ *       than the LCD writer, which can preempt the copy but not be
+ *       preempted by it. A higher-priority task or interrupt that
+ *       preempts alcd_write() while the sequence is odd spins forever,
+ *       since the update in progress can never complete
+ * ------------------------------------------------------- */
+void alcd_snapshot(alcd_vlcd_t *_alcd_copy)
+{
+    uint32_t _sequence = 0;                                        /**< Sequence counter before copy */
+
+    do
+    {
+        do
+        {
+            _sequence = __alcd_vlcd.sequence;                      /**< Wait until no update is in progress */
+        } while(_sequence & 0x01);
+        __DMB();                                                   /**< Read sequence before the copy */
+
+        memcpy(_alcd_copy, (const void *)&__alcd_vlcd, sizeof(alcd_vlcd_t));
+        __DMB();                                                   /**< Complete the copy before re-reading sequence */
+    } while(_sequence != __alcd_vlcd.sequence);                    /**< Retry if the mirror changed meanwhile */
+};
+
+
+/* ============================================================================
+ *                      CUSTOM CHARACTER FUNCTIONS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Create custom character in CGRAM
+ * @param _alcd_CGRAMadd: CGRAM address (0-7) for custom character location
+ * @param _alcd_CGRAMdata: Pointer to 8-byte array containing character pattern
+ * @retval None
+ * @note Each character is 5x8 pixels, represented by 8 bytes
+ *       Each byte defines one row (5 LSBs used)
+ *       After writing, cursor automatically returns to previous position
+ * ------------------------------------------------------- */
+void alcd_customChar(uint8_t _alcd_CGRAMadd, const uint8_t *_alcd_CGRAMdata)
+{
+    uint8_t _forCounter = 0;                                       /**< Loop counter for iterating through 8 character bytes */
+    
+    /* Calculate CGRAM address: base address + (character_index * 8) */
+    uint8_t _CG_Add = __alcd_CGRAM_Start + (_alcd_CGRAMadd << 3);  /**< Shift left by 3 equals multiply by 8 */
+    
+    __alcd_serialBegin();                                          /**< One transaction for the whole glyph */
+    /* Write all 8 bytes of character pattern to CGRAM */
+    for(_forCounter = 0; _forCounter < 8; _forCounter++)           /**< Loop through 8 rows of character pattern */
+    {
+        if(__alcd_urgentPending)                                   /**< Let urgent cells preempt the CGRAM reload */
+        {
+            __alcd_flushUrgent();
+        };
+        alcd_write(_CG_Add++, __alcd_writeCmd);                    /**< Set CGRAM address for current row */
+        alcd_write(*_alcd_CGRAMdata++, __alcd_writeData);          /**< Write pattern data for current row */
+    };
+    
+    alcd_gotoxy(__alcd_x_position, __alcd_y_position);             /**< Restore cursor to position before CGRAM write */
+    __alcd_serialEnd();
+};
+
+
+/* ============================================================================
+ *                       UPDATE QUEUE
+ * ============================================================================ */
+
+#ifdef __alcd_Queue_Enable
+/* -------------------------------------------------------
+ * @brief Mark a run of cells as pending
+ * @param _x: First column
+ * @param _y: Row
+ * @param _length: Number of cells (within the row)
+ * @retval None
+ * @note Interrupts are masked for the read-modify-write, so marks
+ *       from an interrupt and from the main loop are never lost
+ * ------------------------------------------------------- */
+static void __alcd_queueMark(uint8_t _x, uint8_t _y, uint8_t _length)
+{
+    uint32_t _primask = __get_PRIMASK();                           /**< Restore the caller's interrupt state */
+
+    __disable_irq();
+    __alcd_queuePending[_y] |= ((_length >= 32) ? 0xFFFFFFFFUL : ((1UL << _length) - 1)) << _x;
+    __set_PRIMASK(_primask);
+};
+
+/* -------------------------------------------------------
+ * @brief Mark every cell as pending
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_queueMarkAll(void)
+{
+    uint8_t _y = 0;                                                /**< Row counter */
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        __alcd_queueMark(0, _y, __alcd_max_x);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Take and clear the pending mask of a row
+ * @param _y: Row
+ * @retval Pending cells of the row
+ * ------------------------------------------------------- */
+static uint32_t __alcd_queueTake(uint8_t _y)
+{
+    uint32_t _primask = __get_PRIMASK();                           /**< Restore the caller's interrupt state */
+    uint32_t _pending = 0;                                         /**< Cells taken */
+
+    __disable_irq();
+    _pending = __alcd_queuePending[_y];
+    __alcd_queuePending[_y] = 0;
+    __set_PRIMASK(_primask);
+    return _pending;
+};
+
+/* -------------------------------------------------------
+ * @brief Upload pending CGRAM glyphs
+ * @retval None
+ * @note Runs before the cells so that cells showing a glyph appear
+ *       with its new pattern. A pattern replaced during the upload
+ *       is pending again and goes out with the next flush
+ * ------------------------------------------------------- */
+static void __alcd_queueGlyphs(void)
+{
+    uint32_t _primask = 0;                                         /**< Caller's interrupt state */
+    uint8_t _pattern[8];                                           /**< Copy of the pattern being uploaded */
+    uint8_t _slots = 0, _slot = 0;                                 /**< Pending slots, slot counter */
+
+    if(__alcd_queueGlyphPending == 0)
+    {
+        return;
+    };
+
+    _primask = __get_PRIMASK();
+    __disable_irq();
+    _slots = __alcd_queueGlyphPending;
+    __alcd_queueGlyphPending = 0;
+    __set_PRIMASK(_primask);
+
+    for(_slot = 0; _slot < 8; _slot++)
+    {
+        if(bitCheck(_slots, _slot))
+        {
+            memcpy(_pattern, __alcd_queueGlyph[_slot], sizeof(_pattern));
+            alcd_customChar(_slot, _pattern);
+        };
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Queue a CGRAM glyph for the next alcd_flush()
+ * @param _alcd_slot: CGRAM slot (0-7)
+ * @param _alcd_pattern: 8 pattern rows, copied
+ * @retval None
+ * @note Safe to call from an interrupt. A newer pattern for the same
+ *       slot replaces a pending one, so only the latest is uploaded
+ * ------------------------------------------------------- */
+void alcd_fbGlyph(uint8_t _alcd_slot, const uint8_t *_alcd_pattern)
+{
+    uint32_t _primask = 0;                                         /**< Caller's interrupt state */
+
+    if(_alcd_slot >= 8)                                            /**< Ignore slots outside CGRAM */
+    {
+        return;
+    };
+
+    memcpy(__alcd_queueGlyph[_alcd_slot], _alcd_pattern, 8);
+    _primask = __get_PRIMASK();
+    __disable_irq();
+    bitSet(__alcd_queueGlyphPending, _alcd_slot);
+    __set_PRIMASK(_primask);
+};
+
+/* -------------------------------------------------------
+ * @brief Number of pending cells and glyphs
+ * @retval Entries alcd_flush() still has to visit, at most
+ *         __alcd_max_x * __alcd_max_y + 8
+ * ------------------------------------------------------- */
+uint16_t alcd_queueDepth(void)
+{
+    uint16_t _depth = 0;                                           /**< Pending entries */
+    uint32_t _bits = 0;                                            /**< Mask being counted */
+    uint8_t _y = 0;                                                /**< Row counter */
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        for(_bits = __alcd_queuePending[_y]; _bits != 0; _bits &= _bits - 1)  /**< One pass per set bit */
+        {
+            _depth++;
+        };
+    };
+    for(_bits = __alcd_queueGlyphPending; _bits != 0; _bits &= _bits - 1)
+    {
+        _depth++;
+    };
+    return _depth;
+};
+#else
+    #define __alcd_queueMark(_x, _y, _length)  ((void)0)           /**< Flush scans every cell */
+    #define __alcd_queueMarkAll()              ((void)0)
+#endif
+
+
+/* ============================================================================
+ *                       BACKLIGHT CONTROL
+ * ============================================================================ */
+
+#ifdef __alcd_BL_GPIO_Port
+/* -------------------------------------------------------
+ * @brief Control LCD backlight state
+ * @param _alcd_BL: Backlight state (true=ON/GPIO_PIN_SET, false=OFF/GPIO_PIN_RESET)
+ * @retval None
+ * @note Only available if __alcd_BL_GPIO_Port is defined in configuration
+ *       Uses STM32 HAL GPIO function for direct pin control
+ * ------------------------------------------------------- */
+void alcd_backLight(bool _alcd_BL)
+{
+    #ifdef __alcd_Energy_Enable
+    __alcd_energyBacklight();                                      /**< Close ON/OFF interval for accounting */
+    __alcd_energyBL = _alcd_BL;
+    #endif
+    #if defined(__alcd_Lazy_Enable) && defined(__alcd_DarkPanel)
+    __alcd_backLightOn = _alcd_BL;
+    #endif
+    HAL_GPIO_WritePin(__alcd_BL_GPIO_Port, __alcd_BL_Pin, _alcd_BL);  /**< Set backlight GPIO pin to requested state */
+};
+#endif
+
+
+/* ============================================================================
+ *                       DISPLAY CONTROL FUNCTIONS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Configure display, cursor, and blink settings
+ * @param _alcd_Display: Display ON/OFF (true=visible, false=blank)
+ * @param _alcd_Cursor: Cursor visibility ON/OFF (true=underline visible, false=hidden)
+ * @param _alcd_Blink: Cursor blink ON/OFF (true=blinking block, false=steady)
+ * @retval None
+ * @note All three settings can be configured independently
+ *       Settings are combined into single command byte using bit manipulation
+ * ------------------------------------------------------- */
+void alcd_display(bool _alcd_Display, bool _alcd_Cursor, bool _alcd_Blink)
+{
+    /* Start with base display OFF command (0x08) */
+    uint8_t _cursorState = __alcd_Display_OFF;                     /**< Initialize with all features disabled */
+    
+    bitChange(_cursorState, 0, _alcd_Blink);                       /**< Set bit 0: cursor blink enable */
+    bitChange(_cursorState, 1, _alcd_Cursor);                      /**< Set bit 1: cursor visibility enable */
+    bitChange(_cursorState, 2, _alcd_Display);                     /**< Set bit 2: display ON/OFF */
+    
+    #ifdef __alcd_Lazy_Enable
+    if(_alcd_Display && !__alcd_displayOn)                         /**< Becoming visible: send held changes while still dark */
+    {
+        __alcd_displayOn = true;
+        alcd_flush();
+    };
+    __alcd_displayOn = _alcd_Display;
+    #endif
+
+    alcd_write(_cursorState, __alcd_writeCmd);                     /**< Send combined display control command to LCD */
+
+    #ifdef __alcd_Lazy_Enable
+    if(__alcd_cursorMoved && (_alcd_Cursor || _alcd_Blink) && __alcd_isVisible())
+    {
+        alcd_gotoxy(__alcd_x_position, __alcd_y_position);         /**< Visible cursor must sit at the direct API position */
+    };
+    #endif
+};
+
+#ifdef __alcd_Lazy_Enable
+/* -------------------------------------------------------
+ * @brief Report whether the operator can see the display
+ * @param _alcd_visible: true=panel open, false=panel closed
+ * @retval None
+ * @note While closed, updates are only kept in the framebuffer. On
+ *       opening, the net difference is sent in one flush.
+ * ------------------------------------------------------- */
+void alcd_panelVisible(bool _alcd_visible)
+{
+    bool _wasVisible = __alcd_isVisible();                         /**< Visibility before the change */
+
+    __alcd_panelOpen = _alcd_visible;
+    if(!_wasVisible && __alcd_isVisible())
+    {
+        alcd_flush();                                              /**< Apply everything held while closed */
+    };
+};
+#endif
+
+/* -------------------------------------------------------
+ * @brief Clear entire display and reset cursor to home
+ * @retval None
+ * @note This function performs two operations:
+ *       1. Sends clear command to LCD hardware
+ *       2. Resets internal position tracking to (0,0)
+ *       Requires extended delay for clear operation to complete
+ * ------------------------------------------------------- */
+void alcd_clear(void)
+{
+    alcd_write(__alcd_Display_Clear, __alcd_writeCmd);             /**< Send clear display command (0x01) */
+    __alcd_x_position = 0;                                         /**< Reset column position to start */
+    __alcd_y_position = 0;                                         /**< Reset row position to start */
+    __alcd_cursorMoved = false;                                    /**< Clear homes the address counter */
+    memset(__alcd_fb, ' ', sizeof(__alcd_fb));                     /**< Keep framebuffer in sync with cleared DDRAM */
+    __alcd_wait(__alcd_delay_modeSet);                             /**< Wait for clear operation (takes longer than normal commands) */
+};
+
+
+/* ============================================================================
+ *                       CURSOR POSITIONING
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Move cursor to specific position on display
+ * @param _alcd_x: Column position (0 to __alcd_max_x-1, typically 0-15)
+ * @param _alcd_y: Row position (0 to __alcd_max_y-1, typically 0-1)
+ * @retval None
+ * @note Invalid positions (out of bounds) are clamped to (0,0)
+ *       DDRAM addresses: Line 0 starts at 0x80, Line 1 starts at 0xC0
+ * ------------------------------------------------------- */
+void alcd_gotoxy(uint8_t _alcd_x, uint8_t _alcd_y)
+{
+    uint8_t _address = 0x00;                                       /**< Variable to hold calculated DDRAM address */
+
+    /* Validate position boundaries */
+    if(_alcd_x >= __alcd_max_x || _alcd_y >= __alcd_max_y)         /**< Check if position exceeds display dimensions */
+    {
+        __alcd_x_position = 0;                                     /**< Clamp to origin if invalid */
+        __alcd_y_position = 0;
+    }
+    else                                                           /**< Position is valid */
+    {
+        __alcd_x_position = _alcd_x;                               /**< Update internal column tracker */
+        __alcd_y_position = _alcd_y;                               /**< Update internal row tracker */
+    };
+
+    /* Calculate DDRAM address based on row */
+    _address = (__alcd_y_position == 0) ? __alcd_Line1_Start : __alcd_Line2_Start;  /**< Select base address for row 0 or 1 */
+    _address = _address + __alcd_x_position + __alcd_flipShown();  /**< Add column offset to base address (visible page in flip mode) */
+
+    if(!__alcd_isVisible())                                        /**< Invisible: move only the tracked cursor */
+    {
+        __alcd_cursorMoved = true;
+        return;
+    };
+
+    alcd_write(_address, __alcd_writeCmd);                         /**< Send DDRAM address command (bit 7 already set in line start constants) */
+    __alcd_cursorMoved = false;                                    /**< Address counter matches direct API cursor again */
+};
+
+
+/* ============================================================================
+ *                       CHARACTER OUTPUT FUNCTIONS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Print null-terminated string to LCD
+ * @param _str: Pointer to null-terminated character string
+ * @retval None
+ * @note String is printed starting at current cursor position
+ *       Each character advances cursor and may trigger auto-wrap
+ *       Continues until '\0' terminator is encountered
+ * ------------------------------------------------------- */
+void alcd_puts(char* _str)
+{
+    /* Iterate through string until null terminator */
+    while (*_str != '\0')                                          /**< Check for end of string */
+    {
+        alcd_putc(*_str++);                                        /**< Print current character and advance pointer */
+    };  
+};
+
+/* -------------------------------------------------------
+ * @brief Print pre-encoded ROM codes with known length
+ * @param _alcd_codes: HD44780 ROM codes (may include 0x00 = custom character 0)
+ * @param _alcd_length: Number of codes
+ * @retval None
+ * @note Target of the C++ alcd::rom() compile-time encoder; no
+ *       terminator scanning or character mapping at run time
+ * ------------------------------------------------------- */
+void alcd_putn(const uint8_t *_alcd_codes, uint8_t _alcd_length)
+{
+    while(_alcd_length--)
+    {
+        alcd_putc((char)*_alcd_codes++);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Print single character to LCD
+ * @param _char: Character to print (ASCII value)
+ * @retval None
+ * @note Character is printed at current cursor position
+ *       Automatically wraps to next line when reaching end of current line
+ *       Cursor position is tracked internally for proper wrapping
+ * ------------------------------------------------------- */
+void alcd_putc(char _char)
+{
+    #if defined(__alcd_Headless_Enable) && defined(__alcd_Headless_NoShadow)
+    if(!__alcd_present)                                            /**< Null transport without shadow state */
+    {
+        return;
+    };
+    #endif
+
+    if(__alcd_cursorMoved)                                         /**< alcd_flush() left the address counter elsewhere */
+    {
+        alcd_gotoxy(__alcd_x_position, __alcd_y_position);         /**< Restore cursor before writing */
+    };
+
+    __alcd_fb[__alcd_y_position][__alcd_x_position] = _char;       /**< Write through to framebuffer */
+    if(__alcd_isVisible())
+    {
+        alcd_write(_char, __alcd_writeData);                       /**< Send character data to LCD */
+    }
+    else                                                           /**< Invisible: next visible flush sends the cell */
+    {
+        __alcd_cursorMoved = true;
+        __alcd_queueMark(__alcd_x_position, __alcd_y_position, 1);
+    };
+    __alcd_x_position++;                                           /**< Advance to next column */
+    
+    /* Check for end of line condition */
+    if(__alcd_x_position >= __alcd_max_x)                          /**< If cursor reaches end of line */
+    {
+        __alcd_x_position = 0;                                     /**< Reset to first column */
+        __alcd_y_position++;                                       /**< Move to next row */
+        alcd_gotoxy(__alcd_x_position, __alcd_y_position);         /**< Update cursor position on LCD */
+    };
+};
+
+
+/* ============================================================================
+ *                       FRAMEBUFFER FUNCTIONS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Move framebuffer cursor to specified row and column
+ * @param _alcd_x: Column position (0 to __alcd_max_x-1)
+ * @param _alcd_y: Row position (0 to __alcd_max_y-1)
+ * @retval None
+ * @note Invalid positions are clamped to (0,0) like alcd_gotoxy()
+ *       No bus transfer takes place
+ * ------------------------------------------------------- */
+void alcd_fbGotoxy(uint8_t _alcd_x, uint8_t _alcd_y)
+{
+    if(_alcd_x >= __alcd_max_x || _alcd_y >= __alcd_max_y)         /**< Check if position exceeds display dimensions */
+    {
+        _alcd_x = 0;                                               /**< Clamp to origin if invalid */
+        _alcd_y = 0;
+    };
+
+    __alcd_fb_x = _alcd_x;
+    __alcd_fb_y = _alcd_y;
+};
+
+/* -------------------------------------------------------
+ * @brief Write single character into the framebuffer
+ * @param _char: Character to write
+ * @retval None
+ * @note Wraps to the next row at the end of a line and back to (0,0)
+ *       after the last row, matching alcd_putc()
+ * ------------------------------------------------------- */
+void alcd_fbPutc(char _char)
+{
+    alcd_fbSet(__alcd_fb_x, __alcd_fb_y, _char);                   /**< Store character at framebuffer cursor */
+
+    if(++__alcd_fb_x >= __alcd_max_x)                              /**< End of line reached */
+    {
+        __alcd_fb_x = 0;
+        if(++__alcd_fb_y >= __alcd_max_y)                          /**< Past last row: wrap to top */
+        {
+            __alcd_fb_y = 0;
+        };
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Write null-terminated string into the framebuffer
+ * @param _str: Pointer to null-terminated character string
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_fbPuts(const char* _str)
+{
+    while (*_str != '\0')                                          /**< Check for end of string */
+    {
+        alcd_fbPutc(*_str++);                                      /**< Store current character and advance pointer */
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Write pre-encoded ROM codes with known length into the framebuffer
+ * @param _alcd_codes: HD44780 ROM codes
+ * @param _alcd_length: Number of codes
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_fbPutn(const uint8_t *_alcd_codes, uint8_t _alcd_length)
+{
+    while(_alcd_length--)
+    {
+        alcd_fbPutc((char)*_alcd_codes++);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Fill the framebuffer with spaces and home its cursor
+ * @retval None
+ * @note Unlike alcd_clear() no command is sent; the next alcd_flush()
+ *       blanks only the cells that are not already blank
+ * ------------------------------------------------------- */
+void alcd_fbClear(void)
+{
+    memset(__alcd_fb, ' ', sizeof(__alcd_fb));
+    #ifdef __alcd_Profile_Enable
+    memset(__alcd_tagOwner, __alcd_profile.current, sizeof(__alcd_tagOwner));
+    #endif
+    __alcd_queueMarkAll();                                         /**< Every cell may differ now */
+    __alcd_fb_x = 0;
+    __alcd_fb_y = 0;
+};
+
+/* -------------------------------------------------------
+ * @brief Write one framebuffer cell without moving the framebuffer cursor
+ * @param _alcd_x: Column position (0 to __alcd_max_x-1)
+ * @param _alcd_y: Row position (0 to __alcd_max_y-1)
+ * @param _char: Character to store
+ * @retval None
+ * @note Safe to call from an interrupt: only the cell itself and the
+ *       urgent flag are written. Out of range positions are ignored.
+ * ------------------------------------------------------- */
+void alcd_fbSet(uint8_t _alcd_x, uint8_t _alcd_y, char _char)
+{
+    if(_alcd_x >= __alcd_max_x || _alcd_y >= __alcd_max_y)         /**< Ignore cells outside the display */
+    {
+        return;
+    };
+
+    __alcd_fb[_alcd_y][_alcd_x] = _char;
+    #ifdef __alcd_Profile_Enable
+    __alcd_tagOwner[_alcd_y][_alcd_x] = __alcd_profile.current;    /**< Flush charges this cell to the writer */
+    #endif
+    __alcd_queueMark(_alcd_x, _alcd_y, 1);                         /**< Replaces any pending value of the cell */
+    if(bitCheck(__alcd_fbUrgent[_alcd_y], _alcd_x))                /**< Urgent cell: request preemption */
+    {
+        __alcd_urgentPending = true;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Mark a run of cells as urgent or normal priority
+ * @param _alcd_x: First column
+ * @param _alcd_y: Row
+ * @param _alcd_length: Number of cells (clipped at the end of the row)
+ * @param _alcd_urgent: true=urgent lane, false=normal lane
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_fbPriority(uint8_t _alcd_x, uint8_t _alcd_y, uint8_t _alcd_length, bool _alcd_urgent)
+{
+    if(_alcd_y >= __alcd_max_y)                                    /**< Ignore rows outside the display */
+    {
+        return;
+    };
+
+    for(; _alcd_length > 0 && _alcd_x < __alcd_max_x; _alcd_length--, _alcd_x++)
+    {
+        bitChange(__alcd_fbUrgent[_alcd_y], _alcd_x, _alcd_urgent);
+    };
+};
+
+
+/* ============================================================================
+ *                       PRINT CONTEXTS
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Set up a print context for a screen region
+ * @param _alcd_ctx: Context to initialize (owned by the caller)
+ * @param _alcd_x: Region origin column
+ * @param _alcd_y: Region origin row
+ * @param _alcd_width: Region width (clipped to the display)
+ * @param _alcd_height: Region height (clipped to the display)
+ * @param _alcd_wrap: true=wrap to the next region row, false=clip
+ * @retval None
+ * @note A region outside the display gets zero size and ignores output
+ * ------------------------------------------------------- */
+void alcd_ctxInit(alcd_ctx_t *_alcd_ctx, uint8_t _alcd_x, uint8_t _alcd_y, uint8_t _alcd_width, uint8_t _alcd_height, bool _alcd_wrap)
+{
+    if(_alcd_x >= __alcd_max_x || _alcd_y >= __alcd_max_y)         /**< Region starts outside the display */
+    {
+        _alcd_width = 0;
+        _alcd_height = 0;
+    }
+    else
+    {
+        if(_alcd_width > __alcd_max_x - _alcd_x)                   /**< Clip to the right display edge */
+        {
+            _alcd_width = __alcd_max_x - _alcd_x;
+        };
+        if(_alcd_height > __alcd_max_y - _alcd_y)                  /**< Clip to the last display row */
+        {
+            _alcd_height = __alcd_max_y - _alcd_y;
+        };
+    };
+
+    _alcd_ctx->x = _alcd_x;
+    _alcd_ctx->y = _alcd_y;
+    _alcd_ctx->width = _alcd_width;
+    _alcd_ctx->height = _alcd_height;
+    _alcd_ctx->col = 0;
+    _alcd_ctx->row = 0;
+    _alcd_ctx->wrap = _alcd_wrap;
+};
+
+/* -------------------------------------------------------
+ * @brief Move the context cursor
+ * @param _alcd_ctx: Print context
+ * @param _alcd_x: Column relative to the region
+ * @param _alcd_y: Row relative to the region
+ * @retval None
+ * @note Positions outside the region are clamped to its origin like
+ *       alcd_gotoxy(). No bus transfer takes place.
+ * ------------------------------------------------------- */
+void alcd_ctxGotoxy(alcd_ctx_t *_alcd_ctx, uint8_t _alcd_x, uint8_t _alcd_y)
+{
+    if(_alcd_x >= _alcd_ctx->width || _alcd_y >= _alcd_ctx->height)  /**< Outside the region */
+    {
+        _alcd_x = 0;
+        _alcd_y = 0;
+    };
+
+    _alcd_ctx->col = _alcd_x;
+    _alcd_ctx->row = _alcd_y;
+};
+
+/* -------------------------------------------------------
+ * @brief Write single character at the context cursor
+ * @param _alcd_ctx: Print context
+ * @param _char: Character to write
+ * @retval None
+ * @note Writes the framebuffer through alcd_fbSet(), so urgent cells
+ *       keep working. Without wrap the cursor stops at the right edge
+ *       and further characters are dropped.
+ * ------------------------------------------------------- */
+void alcd_ctxPutc(alcd_ctx_t *_alcd_ctx, char _char)
+{
+    if(_alcd_ctx->col >= _alcd_ctx->width || _alcd_ctx->row >= _alcd_ctx->height)  /**< Clipped */
+    {
+        return;
+    };
+
+    alcd_fbSet(_alcd_ctx->x + _alcd_ctx->col, _alcd_ctx->y + _alcd_ctx->row, _char);
+
+    if(++_alcd_ctx->col >= _alcd_ctx->width && _alcd_ctx->wrap)    /**< Right edge of the region */
+    {
+        _alcd_ctx->col = 0;
+        if(++_alcd_ctx->row >= _alcd_ctx->height)                  /**< Past last region row: back to origin */
+        {
+            _alcd_ctx->row = 0;
+        };
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Write null-terminated string at the context cursor
+ * @param _alcd_ctx: Print context
+ * @param _str: Pointer to null-terminated character string
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_ctxPuts(alcd_ctx_t *_alcd_ctx, const char* _str)
+{
+    while (*_str != '\0')                                          /**< Check for end of string */
+    {
+        alcd_ctxPutc(_alcd_ctx, *_str++);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Write pre-encoded ROM codes with known length at the context cursor
+ * @param _alcd_ctx: Print context
+ * @param _alcd_codes: HD44780 ROM codes
+ * @param _alcd_length: Number of codes
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_ctxPutn(alcd_ctx_t *_alcd_ctx, const uint8_t *_alcd_codes, uint8_t _alcd_length)
+{
+    while(_alcd_length--)
+    {
+        alcd_ctxPutc(_alcd_ctx, (char)*_alcd_codes++);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Fill the context region with spaces and home its cursor
+ * @param _alcd_ctx: Print context
+ * @retval None
+ * @note Only the framebuffer is written; cells outside the region and
+ *       other contexts are untouched
+ * ------------------------------------------------------- */
+void alcd_ctxClear(alcd_ctx_t *_alcd_ctx)
+{
+    uint8_t _row = 0;                                              /**< Region row counter */
+
+    for(_row = 0; _row < _alcd_ctx->height; _row++)
+    {
+        memset(&__alcd_fb[_alcd_ctx->y + _row][_alcd_ctx->x], ' ', _alcd_ctx->width);
+        __alcd_queueMark(_alcd_ctx->x, _alcd_ctx->y + _row, _alcd_ctx->width);
+    };
+    _alcd_ctx->col = 0;
+    _alcd_ctx->row = 0;
+};
+
+/* -------------------------------------------------------
+ * @brief Send one framebuffer cell if it differs from the LCD
+ * @param _x: Column
+ * @param _y: Row
+ * @param _page: DDRAM column of the page to write (0 unless page flipping)
+ * @retval true if the cell was sent, false if it was already up to date
+ * @note The controller mirror tells what the DDRAM cell holds and where
+ *       the address counter points, so the set-address command is only
+ *       sent when the counter is not already on this cell
+ * ------------------------------------------------------- */
+static bool __alcd_flushCell(uint8_t _x, uint8_t _y, uint8_t _page)
+{
+    uint8_t _address = 0;                                          /**< DDRAM address command of the cell */
+    #ifdef __alcd_Profile_Enable
+    uint8_t _tag = __alcd_profile.current;                         /**< Tag of the flush caller */
+    #endif
+
+    if(__alcd_fb[_y][_x] == __alcd_vlcd.ddram[_y][_page + _x])     /**< Cell already shows this character */
+    {
+        return false;
+    };
+
+    #ifdef __alcd_Profile_Enable
+    __alcd_profile.current = __alcd_tagOwner[_y][_x];              /**< Charge the cell to the tag that wrote it */
+    #endif
+
+    _address = ((_y == 0) ? __alcd_Line1_Start : __alcd_Line2_Start) + _page + _x;
+    if(__alcd_vlcd.cgramSelect || (__alcd_vlcd.address | 0x80) != _address)
+    {
+        alcd_write(_address, __alcd_writeCmd);                     /**< Move address counter only when needed */
+    };
+    alcd_write(__alcd_fb[_y][_x], __alcd_writeData);               /**< Send changed character */
+    __alcd_cursorMoved = true;                                     /**< Direct API cursor must be restored */
+    #ifdef __alcd_Profile_Enable
+    __alcd_profile.current = _tag;
+    #endif
+    return true;
+};
+
+#ifdef __alcd_Flip_Enable
+/* -------------------------------------------------------
+ * @brief Check whether the visible page matches the framebuffer
+ * @retval true if no visible cell differs from __alcd_fb
+ * ------------------------------------------------------- */
+static bool __alcd_flipCurrent(void)
+{
+    uint8_t _y = 0;                                                /**< Row counter */
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        if(memcmp(__alcd_fb[_y], &__alcd_vlcd.ddram[_y][__alcd_flipShown()], __alcd_max_x) != 0)
+        {
+            return false;
+        };
+    };
+    return true;
+};
+
+/* -------------------------------------------------------
+ * @brief Shift the display window onto a page
+ * @param _page: DDRAM column of the page (0 or __alcd_max_x)
+ * @retval None
+ * @note Display shift commands leave DDRAM and the address counter
+ *       alone; the mirror tracks the shift, so the loop also recovers
+ *       from shifts applied by other code
+ * ------------------------------------------------------- */
+static void __alcd_flipTo(uint8_t _page)
+{
+    while(__alcd_vlcd.shift != _page)
+    {
+        alcd_write((__alcd_vlcd.shift < _page) ? 0x18 : 0x1C, __alcd_writeCmd);  /**< Display shift left / right */
+        #if defined(__alcd_Headless_Enable) && defined(__alcd_Headless_NoShadow)
+        if(!__alcd_present)                                        /**< Null transport without shadow state: mirror does not move */
+        {
+            return;
+        };
+        #endif
+    };
+    __alcd_cursorMoved = true;                                     /**< Direct API cursor now addresses the other page */
+};
+
+/* -------------------------------------------------------
+ * @brief Enable or disable page flipping for alcd_flush()
+ * @param _alcd_flip: true=flush into the hidden page and flip,
+ *                    false=flush into the visible cells as usual
+ * @retval None
+ * @note Leaving flip mode flushes once more so the screen ends on
+ *       page 0 with the current framebuffer
+ * ------------------------------------------------------- */
+void alcd_flipMode(bool _alcd_flip)
+{
+    if(!_alcd_flip && __alcd_flipActive && __alcd_vlcd.shift != 0)
+    {
+        if(__alcd_flipShown() != 0)                                /**< Page 1 shown: flip to an updated page 0 */
+        {
+            alcd_flush();
+        };
+        __alcd_flipTo(0);
+    };
+    __alcd_flipActive = _alcd_flip;
+};
+#endif
+
+/* -------------------------------------------------------
+ * @brief Send all changed urgent cells
+ * @retval Number of cells sent
+ * @note Leaves the address counter wherever the last urgent cell was
+ *       written; the interrupted transfer re-addresses as needed
+ * ------------------------------------------------------- */
+static uint16_t __alcd_flushUrgent(void)
+{
+    uint8_t _x = 0, _y = 0;                                        /**< Cell counters */
+    uint16_t _sent = 0;                                            /**< Number of cells sent */
+
+    if(!__alcd_isVisible())                                        /**< Held until the display is visible */
+    {
+        return 0;
+    };
+
+    __alcd_urgentPending = false;                                  /**< Clear first so new writes are not lost */
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        if(__alcd_fbUrgent[_y] == 0)                               /**< No urgent cells on this row */
+        {
+            continue;
+        };
+        for(_x = 0; _x < __alcd_max_x; _x++)
+        {
+            if(bitCheck(__alcd_fbUrgent[_y], _x))
+            {
+                _sent += __alcd_flushCell(_x, _y, __alcd_flipShown());  /**< Urgent cells go to the visible page */
+            };
+        };
+    };
+
+    return _sent;
+};
+
+/* -------------------------------------------------------
+ * @brief Send framebuffer cells that differ from the LCD contents
+ * @retval Number of cells sent
+ * @note A set-address command is only sent when the next changed cell
+ *       is not where the address counter already is, so a single
+ *       changed character costs at most two bytes.
+ *       Urgent cells (alcd_fbPriority) go first, and the normal lane
+ *       yields to newly written urgent cells between bytes.
+ *       The direct API cursor is restored lazily by the next alcd_putc()
+ * ------------------------------------------------------- */
+uint16_t alcd_flush(void)
+{
+    uint8_t _x = 0, _y = 0;                                        /**< Cell counters */
+    #ifdef __alcd_Energy_Enable
+    alcd_stats_t _start = __alcd_stats;                            /**< Counters before the flush */
+    #endif
+    #ifdef __alcd_Profile_Enable
+    uint32_t _startCycles = DWT->CYCCNT;                           /**< Flush time for the caller's tag */
+    #endif
+    uint16_t _sent = 0;                                            /**< Cells sent */
+    #ifdef __alcd_Queue_Enable
+    uint32_t _pending = 0;                                         /**< Pending cells of the current row */
+    #endif
+
+    #if defined(__alcd_Headless_Enable) && defined(__alcd_Headless_NoShadow)
+    if(!__alcd_present)                                            /**< Null transport without shadow state */
+    {
+        return 0;
+    };
+    #endif
+
+    if(!__alcd_isVisible())                                        /**< Display off or panel closed: hold changes */
+    {
+        return 0;
+    };
+
+    __alcd_serialBegin();                                          /**< Serial backend: whole flush in one transaction */
+    #ifdef __alcd_Queue_Enable
+    __alcd_queueGlyphs();                                          /**< Newest glyph patterns before the cells */
+    #endif
+    _sent = __alcd_flushUrgent();                                  /**< Urgent lane first */
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        #ifdef __alcd_Queue_Enable
+        _pending = __alcd_queueTake(_y);                           /**< Later writes stay pending for the next flush */
+        #ifdef __alcd_Flip_Enable
+        _pending = __alcd_flipActive ? __alcd_queueRowMask : _pending;  /**< Hidden page needs the full scan */
+        #endif
+        if(_pending == 0)                                          /**< Nothing queued on this row */
+        {
+            continue;
+        };
+        #endif
+        for(_x = 0; _x < __alcd_max_x; _x++)
+        {
+            #ifdef __alcd_Queue_Enable
+            if(!bitCheck(_pending, _x))
+            {
+                continue;
+            };
+            #endif
+            if(__alcd_urgentPending)                               /**< Preempt normal lane between bytes */
+            {
+                _sent += __alcd_flushUrgent();
+            };
+            _sent += __alcd_flushCell(_x, _y, __alcd_flipHidden());
+        };
+    };
+
+    #ifdef __alcd_Flip_Enable
+    if(__alcd_flipActive && !__alcd_flipCurrent())                 /**< Visible page is behind: show the hidden one */
+    {
+        __alcd_flipTo(__alcd_flipHidden());
+    };
+    #endif
+    __alcd_serialEnd();
+    #ifdef __alcd_History_Enable
+    __alcd_historyRecord();                                        /**< Queue what the operator now sees */
+    #endif
+
+    #ifdef __alcd_Energy_Enable
+    __alcd_energy.flushNj = __alcd_energyClip(__alcd_energyBus(&_start, &__alcd_stats));
+    #endif
+    #ifdef __alcd_Profile_Enable
+    __alcd_profile.tag[__alcd_profile.current].flushes++;
+    __alcd_profile.tag[__alcd_profile.current].flushCycles += DWT->CYCCNT - _startCycles;
+    #endif
+
+    return _sent;
+};
+
+
+#ifdef __alcd_Graphic_Enable
+/* ============================================================================
+ *                       GRAPHIC MODE (WS0010 OLED)
+ * ============================================================================ */
+
+/* -------------------------------------------------------
+ * @brief Store one column byte and mark it dirty if it changed
+ * @param _x: Column
+ * @param _page: Page
+ * @param _bits: New column byte
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_gfxSet(uint8_t _x, uint8_t _page, uint8_t _bits)
+{
+    if(__alcd_gfx[_page][_x] != _bits)
+    {
+        __alcd_gfx[_page][_x] = _bits;
+        bitSet(__alcd_gfxDirty[_page][_x >> 3], _x & 0x07);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Check whether a column is dirty
+ * @param _x: Column (may be past the last column)
+ * @param _page: Page
+ * @retval true if the column must be uploaded
+ * ------------------------------------------------------- */
+static bool __alcd_gfxIsDirty(uint8_t _x, uint8_t _page)
+{
+    return (_x < __alcd_Gfx_Width) && bitCheck(__alcd_gfxDirty[_page][_x >> 3], _x & 0x07);
+};
+
+/* -------------------------------------------------------
+ * @brief Switch between text mode and graphic mode
+ * @param _alcd_graphic: true=graphic mode, false=text mode
+ * @retval None
+ * @note Entering graphic mode uploads the whole pixel framebuffer.
+ *       Returning to text mode clears the controller and sends the
+ *       text framebuffer again, so text written meanwhile appears.
+ *       Only for WS0010/US2066 type controllers: an HD44780 would
+ *       execute the mode commands as display shifts.
+ * ------------------------------------------------------- */
+void alcd_gfxMode(bool _alcd_graphic)
+{
+    if(_alcd_graphic)
+    {
+        alcd_write(__alcd_Gfx_GraphicMode, __alcd_writeCmd);
+        __alcd_gfxActive = true;
+        memset(__alcd_gfxDirty, 0xFF, sizeof(__alcd_gfxDirty));   /**< Graphic RAM content unknown */
+        alcd_gfxFlush();
+        return;
+    };
+
+    __alcd_gfxActive = false;
+    alcd_write(__alcd_Gfx_TextMode, __alcd_writeCmd);
+    alcd_write(__alcd_Display_Clear, __alcd_writeCmd);             /**< Mirror now matches a blank controller */
+    __alcd_wait(__alcd_delay_modeSet);
+    __alcd_cursorMoved = true;                                     /**< Clear homed the address counter */
+    __alcd_queueMarkAll();                                         /**< Every text cell must be resent */
+    alcd_flush();                                                  /**< Text back from the framebuffer */
+};
+
+/* -------------------------------------------------------
+ * @brief Clear the pixel framebuffer
+ * @retval None
+ * @note Only non-blank columns become dirty
+ * ------------------------------------------------------- */
+void alcd_gfxClear(void)
+{
+    uint8_t _x = 0, _page = 0;                                     /**< Column and page counters */
+
+    for(_page = 0; _page < __alcd_Gfx_Pages; _page++)
+    {
+        for(_x = 0; _x < __alcd_Gfx_Width; _x++)
+        {
+            __alcd_gfxSet(_x, _page, 0x00);
+        };
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Set or clear one pixel in the pixel framebuffer
+ * @param _alcd_x: Column (0 to __alcd_Gfx_Width-1)
+ * @param _alcd_y: Row (0 to __alcd_Gfx_Height-1), 0 is the top
+ * @param _alcd_on: true=pixel lit
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_gfxPixel(uint8_t _alcd_x, uint8_t _alcd_y, bool _alcd_on)
+{
+    uint8_t _bits = 0;                                             /**< Column byte */
+
+    if(_alcd_x >= __alcd_Gfx_Width || _alcd_y >= __alcd_Gfx_Height)
+    {
+        return;
+    };
+
+    _bits = __alcd_gfx[_alcd_y >> 3][_alcd_x];
+    bitChange(_bits, _alcd_y & 0x07, _alcd_on);
+    __alcd_gfxSet(_alcd_x, _alcd_y >> 3, _bits);
+};
+
+/* -------------------------------------------------------
+ * @brief Copy a page-format bitmap into the pixel framebuffer
+ * @param _alcd_x: First column
+ * @param _alcd_page: First page
+ * @param _alcd_width: Bitmap width in columns
+ * @param _alcd_pages: Bitmap height in pages
+ * @param _alcd_bitmap: Column bytes (bit 0 at the top), page after page
+ * @retval None
+ * @note Same layout as vertical-byte bitmap converters produce;
+ *       parts outside the screen are clipped
+ * ------------------------------------------------------- */
+void alcd_gfxBitmap(uint8_t _alcd_x, uint8_t _alcd_page, uint8_t _alcd_width, uint8_t _alcd_pages, const uint8_t *_alcd_bitmap)
+{
+    uint8_t _x = 0, _page = 0;                                     /**< Column and page counters */
+
+    for(_page = 0; _page < _alcd_pages && _alcd_page + _page < __alcd_Gfx_Pages; _page++)
+    {
+        for(_x = 0; _x < _alcd_width && _alcd_x + _x < __alcd_Gfx_Width; _x++)
+        {
+            __alcd_gfxSet(_alcd_x + _x, _alcd_page + _page, _alcd_bitmap[_page * _alcd_width + _x]);
+        };
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Upload dirty columns of the pixel framebuffer
+ * @retval Number of column bytes sent
+ * @note Each run of dirty columns costs GXA + GYA + one byte per
+ *       column. Clean gaps of up to two columns inside a run are
+ *       resent, which is cheaper than readdressing. Does nothing in
+ *       text mode; the columns stay dirty until graphic mode is used.
+ * ------------------------------------------------------- */
+uint16_t alcd_gfxFlush(void)
+{
+    uint8_t _x = 0, _page = 0;                                     /**< Column and page counters */
+    uint8_t _next = 0xFF;                                          /**< Column the X address counter points to, 0xFF = unknown */
+    uint16_t _sent = 0;                                            /**< Column bytes sent */
+
+    if(!__alcd_gfxActive)
+    {
+        return 0;
+    };
+
+    for(_page = 0; _page < __alcd_Gfx_Pages; _page++)
+    {
+        _next = 0xFF;                                              /**< New page needs GYA */
+        for(_x = 0; _x < __alcd_Gfx_Width; _x++)
+        {
+            if(!__alcd_gfxIsDirty(_x, _page) && !(_next == _x && (__alcd_gfxIsDirty(_x + 1, _page) || __alcd_gfxIsDirty(_x + 2, _page))))
+            {
+                continue;                                          /**< Clean and not bridging a short gap */
+            };
+            if(_next != _x)
+            {
+                alcd_write(__alcd_Gfx_X | _x, __alcd_writeCmd);
+                alcd_write(__alcd_Gfx_Y | _page, __alcd_writeCmd);
+            };
+            alcd_write(__alcd_gfx[_page][_x], __alcd_writeData);
+            bitClear(__alcd_gfxDirty[_page][_x >> 3], _x & 0x07);
+            _next = _x + 1;                                        /**< X address auto-increments */
+            _sent++;
+        };
+    };
+
+    return _sent;
+};
+#endif
+
+
+#ifdef __alcd_Governor_Enable
+/* ============================================================================
+ *                       REFRESH GOVERNOR
+ * ============================================================================ */
+uint16_t __alcd_govPeriod = __alcd_Gov_MinPeriod;  /**< Current refresh period in ms */
+uint32_t __alcd_govLast = 0;                 /**< Tick of the last periodic flush */
+volatile bool __alcd_govActivity = false;    /**< User interaction reported since last flush */
+uint8_t __alcd_govLoad = 0;                  /**< CPU load of the last window in percent */
+uint32_t __alcd_govIdleCycles = 0;           /**< Idle cycles accumulated in the current window */
+uint32_t __alcd_govIdleStart = 0;            /**< Cycle counter at alcd_idleEnter() */
+uint32_t __alcd_govWindowCycles = 0;         /**< Cycle counter at start of the load window */
+uint32_t __alcd_govWindowTick = 0;           /**< Tick at start of the load window */
+bool __alcd_govMeasured = false;             /**< alcd_idleEnter() has been used */
+
+/* -------------------------------------------------------
+ * @brief Report user interaction to raise the refresh rate immediately
+ * @retval None
+ * @note Safe to call from an interrupt (e.g. key EXTI)
+ * ------------------------------------------------------- */
+void alcd_activity(void)
+{
+    __alcd_govActivity = true;
+};
+
+/* -------------------------------------------------------
+ * @brief Mark the start of an idle period for CPU load measurement
+ * @retval None
+ * @note Call right before the idle work (e.g. __WFI()) of the main
+ *       loop, and alcd_idleExit() right after it. Without these calls
+ *       the governor assumes an idle CPU.
+ * ------------------------------------------------------- */
+void alcd_idleEnter(void)
+{
+    if(!__alcd_govMeasured)                                        /**< First use: start cycle counter and window */
+    {
+        __alcd_dwtEnable();
+        __alcd_govMeasured = true;
+        __alcd_govWindowCycles = DWT->CYCCNT;
+        __alcd_govWindowTick = HAL_GetTick();
+    };
+    __alcd_govIdleStart = DWT->CYCCNT;
+};
+
+/* -------------------------------------------------------
+ * @brief Close the load window and compute the CPU load
+ * @param _now: Cycle counter at the end of the window
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_govWindowClose(uint32_t _now)
+{
+    uint32_t _total = _now - __alcd_govWindowCycles;               /**< Window length in cycles */
+
+    __alcd_govLoad = (__alcd_govIdleCycles >= _total) ? 0 : (uint8_t)(100 - (uint64_t)__alcd_govIdleCycles * 100U / _total);
+    __alcd_govIdleCycles = 0;
+    __alcd_govWindowCycles = _now;
+    __alcd_govWindowTick = HAL_GetTick();
+};
+
+/* -------------------------------------------------------
+ * @brief Mark the end of an idle period for CPU load measurement
+ * @retval None
+ * ------------------------------------------------------- */
+void alcd_idleExit(void)
+{
+    uint32_t _now = DWT->CYCCNT;                                   /**< Cycle counter at end of idle period */
+
+    __alcd_govIdleCycles += _now - __alcd_govIdleStart;
+
+    if(HAL_GetTick() - __alcd_govWindowTick >= __alcd_Gov_Window)  /**< Load window complete */
+    {
+        __alcd_govWindowClose(_now);
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Flush the framebuffer when the adaptive refresh period has elapsed
+ * @retval None
+ * @note Call from the main loop as often as possible. Each periodic
+ *       flush re-tunes the period:
+ *       - user activity        : fastest rate (__alcd_Gov_MinPeriod)
+ *       - CPU above busy load  : period doubled
+ *       - cells changed        : period halved
+ *       - screen static        : period doubled
+ *       The period stays within __alcd_Gov_MinPeriod..__alcd_Gov_MaxPeriod.
+ *       Urgent cells bypass the governor and are flushed on every call.
+ *       Also closes a load window that no alcd_idleExit() closed, so a
+ *       loop that stops idling is seen as busy
+ * ------------------------------------------------------- */
+void alcd_task(void)
+{
+    uint32_t _now = HAL_GetTick();                                 /**< Current tick in ms */
+    uint16_t _sent = 0;                                            /**< Cells sent by the periodic flush */
+    uint16_t _minPeriod = __alcd_Gov_MinPeriod;                    /**< Fastest period allowed now */
+    bool _activity = __alcd_govActivity;                           /**< Activity may force an immediate flush */
+
+    #ifdef __alcd_Energy_Enable
+    alcd_energyTask();
+    if(__alcd_energy.level >= 1)                                   /**< Power budget: batch updates, lower rate */
+    {
+        _activity = false;
+        _minPeriod = (__alcd_energy.level >= 2) ? __alcd_Gov_MaxPeriod : __alcd_Gov_MinPeriod * 4;
+    };
+    #endif
+
+    #if defined(__alcd_Lazy_Enable) && defined(__alcd_DarkPanel)
+    if(!__alcd_backLightOn)                                        /**< Dark panel unreadable: refresh rarely */
+    {
+        _activity = false;
+        _minPeriod = __alcd_Gov_DarkPeriod;
+    };
+    #endif
+
+    if(__alcd_urgentPending)                                       /**< Urgent lane is never delayed */
+    {
+        __alcd_flushUrgent();
+    };
+
+    if(__alcd_govMeasured && (_now - __alcd_govWindowTick) >= __alcd_Gov_Window)
+    {
+        __alcd_govWindowClose(DWT->CYCCNT);                        /**< No idle period ended the window: age the load */
+    };
+
+    if(!_activity && (_now - __alcd_govLast) < __alcd_govPeriod)
+    {
+        return;                                                    /**< Not due yet */
+    };
+
+    __alcd_govLast = _now;
+    _sent = alcd_flush();
+
+    if(__alcd_govActivity)                                         /**< Interaction: respond at full rate */
+    {
+        __alcd_govActivity = false;
+        __alcd_govPeriod = _minPeriod;
+    }
+    else if(__alcd_govLoad > __alcd_Gov_BusyLoad || _sent == 0)    /**< Busy CPU or static screen: back off */
+    {
+        __alcd_govPeriod = (__alcd_govPeriod * 2 > __alcd_Gov_MaxPeriod) ? __alcd_Gov_MaxPeriod : __alcd_govPeriod * 2;
+    }
+    else                                                           /**< Values changing: speed up */
+    {
+        __alcd_govPeriod = (__alcd_govPeriod / 2 < _minPeriod) ? _minPeriod : __alcd_govPeriod / 2;
+    };
+
+    if(__alcd_govPeriod < _minPeriod)                              /**< Policy level raised the floor */
+    {
+        __alcd_govPeriod = _minPeriod;
+    };
+};
+#endif
+
+
+#ifdef __alcd_Clock_Enable
+/* ============================================================================
+ *                       CLOCK WIDGET
+ * ============================================================================ */
+volatile uint32_t __alcd_clockTicks = 0;     /**< Seconds signalled by the RTC interrupt */
+uint32_t __alcd_clockSeen = 0;               /**< Seconds already consumed by alcd_clockTask() */
+uint8_t __alcd_clockTime[3] = {0, 0, 0};     /**< Hours, minutes, seconds */
+uint8_t __alcd_clockDay = 1;                 /**< Day of month (1-31) */
+uint8_t __alcd_clockMonth = 1;               /**< Month (1-12) */
+uint16_t __alcd_clockYear = 2000;            /**< Year */
+uint8_t __alcd_clockPos[2] = {0xFF, 0xFF};   /**< Time position (x, y), 0xFF = not shown */
+uint8_t __alcd_datePos[2] = {0xFF, 0xFF};    /**< Date position (x, y), 0xFF = not shown */
+uint8_t __alcd_bigPos[2] = {0xFF, 0xFF};     /**< Big HH:MM position (x, top row), 0xFF = not shown */
+
+/* -------------------------------------------------------
+ * @brief Big digit glyphs, loaded to __alcd_Clock_BigSlot onwards
+ * @note Upper bar, lower bar, both bars, full block, colon dot
+ * ------------------------------------------------------- */
+static const uint8_t __alcd_bigGlyph[5][8] =
+{
+    {0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F},
+    {0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F},
+    {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F},
+    {0x00, 0x00, 0x00, 0x0E, 0x0E, 0x00, 0x00, 0x00},
+};
+
+/* -------------------------------------------------------
+ * @brief Big digits, 3 cells wide and 2 rows high
+ * @note Top row then bottom row; values are glyph offsets,
+ *       4 is a blank cell
+ * ------------------------------------------------------- */
+static const uint8_t __alcd_bigDigit[10][6] =
+{
+    {3, 0, 3, 3, 1, 3},                                            /**< 0 */
+    {0, 3, 4, 1, 3, 1},                                            /**< 1 */
+    {2, 2, 3, 3, 1, 1},                                            /**< 2 */
+    {0, 2, 3, 1, 1, 3},                                            /**< 3 */
+    {3, 1, 3, 4, 4, 3},                                            /**< 4 */
+    {3, 2, 2, 1, 1, 3},                                            /**< 5 */
+    {3, 2, 2, 3, 1, 3},                                            /**< 6 */
+    {0, 0, 3, 4, 4, 3},                                            /**< 7 */
+    {3, 2, 3, 3, 1, 3},                                            /**< 8 */
+    {3, 2, 3, 1, 1, 3},                                            /**< 9 */
+};
+
+/* -------------------------------------------------------
+ * @brief Place the HH:MM:SS clock widget on the screen
+ * @param _alcd_x: Column of the first hour digit
+ * @param _alcd_y: Row of the clock
+ * @retval None
+ * @note The widget needs 8 cells; positions that do not fit are ignored
+ * ------------------------------------------------------- */
+void alcd_clockInit(uint8_t _alcd_x, uint8_t _alcd_y)
+{
+    if(_alcd_x + 8 > __alcd_max_x || _alcd_y >= __alcd_max_y)      /**< Widget must fit on the row */
+    {
+        return;
+    };
+
+    __alcd_clockPos[0] = _alcd_x;
+    __alcd_clockPos[1] = _alcd_y;
+    __alcd_clockSeen = __alcd_clockTicks;                          /**< Ignore seconds signalled before start */
+};
+
+/* -------------------------------------------------------
+ * @brief Show the DD/MM/YYYY date at the given position
+ * @param _alcd_x: Column of the first day digit
+ * @param _alcd_y: Row of the date
+ * @retval None
+ * @note The date needs 10 cells; positions that do not fit are ignored
+ * ------------------------------------------------------- */
+void alcd_clockDate(uint8_t _alcd_x, uint8_t _alcd_y)
+{
+    if(_alcd_x + 10 > __alcd_max_x || _alcd_y >= __alcd_max_y)     /**< Date must fit on the row */
+    {
+        return;
+    };
+
+    __alcd_datePos[0] = _alcd_x;
+    __alcd_datePos[1] = _alcd_y;
+};
+
+/* -------------------------------------------------------
+ * @brief Show HH:MM in big digits on two rows
+ * @param _alcd_x: Column of the first hour digit
+ * @param _alcd_y: Top row of the digits
+ * @retval None
+ * @note The digits need 15 cells on rows _alcd_y and _alcd_y + 1
+ *       (a 16x2 display has room for them); positions that do not fit
+ *       are ignored. Loads five glyphs into CGRAM slots
+ *       __alcd_Clock_BigSlot to __alcd_Clock_BigSlot + 4
+ * ------------------------------------------------------- */
+void alcd_clockBig(uint8_t _alcd_x, uint8_t _alcd_y)
+{
+    uint8_t _index = 0;                                            /**< Glyph counter */
+
+    if(_alcd_x + 15 > __alcd_max_x || _alcd_y + 1 >= __alcd_max_y) /**< Digits must fit on both rows */
+    {
+        return;
+    };
+
+    for(_index = 0; _index < 5; _index++)
+    {
+        alcd_customChar(__alcd_Clock_BigSlot + _index, __alcd_bigGlyph[_index]);
+    };
+    __alcd_bigPos[0] = _alcd_x;
+    __alcd_bigPos[1] = _alcd_y;
+    __alcd_clockSeen = __alcd_clockTicks;                          /**< Ignore seconds signalled before start */
+};
+
+/* -------------------------------------------------------
+ * @brief Set the current time of the clock widget
+ * @param _alcd_hour: Hours (0-23)
+ * @param _alcd_minute: Minutes (0-59)
+ * @param _alcd_second: Seconds (0-59)
+ * @retval None
+ * @note Use it to resynchronize with HAL_RTC_GetTime() when needed.
+ *       Out of range values are clamped like alcd_clockSetDate():
+ *       hours to 23, minutes and seconds to 59
+ * ------------------------------------------------------- */
+void alcd_clockSet(uint8_t _alcd_hour, uint8_t _alcd_minute, uint8_t _alcd_second)
+{
+    __alcd_clockTime[0] = (_alcd_hour > 23) ? 23 : _alcd_hour;
+    __alcd_clockTime[1] = (_alcd_minute > 59) ? 59 : _alcd_minute;
+    __alcd_clockTime[2] = (_alcd_second > 59) ? 59 : _alcd_second;
+};
+
+/* -------------------------------------------------------
+ * @brief Number of days in a month
+ * @param _month: Month (1-12)
+ * @param _year: Year, for February of leap years
+ * @retval Days in the month
+ * ------------------------------------------------------- */
+static uint8_t __alcd_clockMonthDays(uint8_t _month, uint16_t _year)
+{
+    static const uint8_t _days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if(_month == 2 && ((_year % 4 == 0 && _year % 100 != 0) || _year % 400 == 0))
+    {
+        return 29;                                                 /**< February of a leap year */
+    };
+    return _days[(_month - 1) % 12];
+};
+
+/* -------------------------------------------------------
+ * @brief Set the current date of the clock widget
+ * @param _alcd_day: Day of month (1-31)
+ * @param _alcd_month: Month (1-12)
+ * @param _alcd_year: Year (0-9999, e.g. 2025)
+ * @retval None
+ * @note Out of range values are clamped: month to 1-12, day to the
+ *       length of that month, year to 9999
+ * ------------------------------------------------------- */
+void alcd_clockSetDate(uint8_t _alcd_day, uint8_t _alcd_month, uint16_t _alcd_year)
+{
+    uint8_t _length = 0;                                           /**< Days in the clamped month */
+
+    _alcd_month = (_alcd_month < 1) ? 1 : (_alcd_month > 12) ? 12 : _alcd_month;
+    _alcd_year = (_alcd_year > 9999) ? 9999 : _alcd_year;
+    _length = __alcd_clockMonthDays(_alcd_month, _alcd_year);
+    _alcd_day = (_alcd_day < 1) ? 1 : (_alcd_day > _length) ? _length : _alcd_day;
+
+    __alcd_clockDay = _alcd_day;
+    __alcd_clockMonth = _alcd_month;
+    __alcd_clockYear = _alcd_year;
+};
+
+/* -------------------------------------------------------
+ * @brief Signal one elapsed second
+ * @retval None
+ * @note Call from the RTC second interrupt, e.g. in
+ *       HAL_RTCEx_RTCEventCallback(). Only a counter is incremented,
+ *       all time keeping and formatting happens in alcd_clockTask()
+ * ------------------------------------------------------- */
+void alcd_clockTick(void)
+{
+    __alcd_clockTicks++;
+};
+
+/* -------------------------------------------------------
+ * @brief Write a two digit number into the framebuffer
+ * @param _x: Column of the first digit
+ * @param _y: Row
+ * @param _value: Value (0-99)
+ * @retval None
+ * @note Goes through alcd_fbSet() like every other framebuffer writer
+ * ------------------------------------------------------- */
+static void __alcd_clockDigits(uint8_t _x, uint8_t _y, uint8_t _value)
+{
+    alcd_fbSet(_x, _y, '0' + (_value / 10));
+    alcd_fbSet(_x + 1, _y, '0' + (_value % 10));
+};
+
+/* -------------------------------------------------------
+ * @brief Write one big digit into the framebuffer
+ * @param _x: Left column of the digit
+ * @param _y: Top row of the digit
+ * @param _value: Digit (0-9)
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_clockBigDigit(uint8_t _x, uint8_t _y, uint8_t _value)
+{
+    uint8_t _cell = 0, _part = 0;                                  /**< Cell counter, glyph offset */
+
+    for(_cell = 0; _cell < 6; _cell++)
+    {
+        _part = __alcd_bigDigit[_value][_cell];
+        alcd_fbSet(_x + _cell % 3, _y + _cell / 3, (_part == 4) ? ' ' : (char)(__alcd_Clock_BigSlot + _part));
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Advance one day, handling month length and leap years
+ * @retval None
+ * ------------------------------------------------------- */
+static void __alcd_clockNextDay(void)
+{
+    uint8_t _length = __alcd_clockMonthDays(__alcd_clockMonth, __alcd_clockYear);  /**< Length of current month */
+
+    if(++__alcd_clockDay > _length)
+    {
+        __alcd_clockDay = 1;
+        if(++__alcd_clockMonth > 12)
+        {
+            __alcd_clockMonth = 1;
+            __alcd_clockYear++;
+        };
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Advance and redraw the clock widget
+ * @retval None
+ * @note Call from the main loop. Consumes the seconds signalled by
+ *       alcd_clockTick(), formats time and date into the framebuffer
+ *       and flushes. Only digits that actually changed reach the bus,
+ *       which is usually a single character per second.
+ * ------------------------------------------------------- */
+void alcd_clockTask(void)
+{
+    uint32_t _ticks = __alcd_clockTicks;                           /**< Single read of the interrupt counter */
+    uint8_t _x = __alcd_clockPos[0], _y = __alcd_clockPos[1];     /**< Clock position */
+
+    if(_ticks == __alcd_clockSeen || (_x == 0xFF && __alcd_bigPos[0] == 0xFF))  /**< Nothing elapsed or no clock placed */
+    {
+        return;
+    };
+
+    while(__alcd_clockSeen != _ticks)                              /**< Catch up on every elapsed second */
+    {
+        __alcd_clockSeen++;
+        if(++__alcd_clockTime[2] < 60) continue;
+        __alcd_clockTime[2] = 0;
+        if(++__alcd_clockTime[1] < 60) continue;
+        __alcd_clockTime[1] = 0;
+        if(++__alcd_clockTime[0] < 24) continue;
+        __alcd_clockTime[0] = 0;
+        __alcd_clockNextDay();
+    };
+
+    if(_x != 0xFF)                                                 /**< HH:MM:SS shown */
+    {
+        __alcd_clockDigits(_x, _y, __alcd_clockTime[0]);           /**< HH */
+        alcd_fbSet(_x + 2, _y, ':');
+        __alcd_clockDigits(_x + 3, _y, __alcd_clockTime[1]);       /**< MM */
+        alcd_fbSet(_x + 5, _y, ':');
+        __alcd_clockDigits(_x + 6, _y, __alcd_clockTime[2]);       /**< SS */
+    };
+
+    if(__alcd_bigPos[0] != 0xFF)                                   /**< Big HH:MM shown, cells change once a minute */
+    {
+        _x = __alcd_bigPos[0];
+        _y = __alcd_bigPos[1];
+        __alcd_clockBigDigit(_x, _y, __alcd_clockTime[0] / 10);
+        __alcd_clockBigDigit(_x + 4, _y, __alcd_clockTime[0] % 10);
+        alcd_fbSet(_x + 7, _y, (char)(__alcd_Clock_BigSlot + 4));  /**< Colon */
+        alcd_fbSet(_x + 7, _y + 1, (char)(__alcd_Clock_BigSlot + 4));
+        __alcd_clockBigDigit(_x + 8, _y, __alcd_clockTime[1] / 10);
+        __alcd_clockBigDigit(_x + 12, _y, __alcd_clockTime[1] % 10);
+    };
+
+    if(__alcd_datePos[0] != 0xFF)                                  /**< Date shown */
+    {
+        _x = __alcd_datePos[0];
+        _y = __alcd_datePos[1];
+        __alcd_clockDigits(_x, _y, __alcd_clockDay);               /**< DD */
+        alcd_fbSet(_x + 2, _y, '/');
+        __alcd_clockDigits(_x + 3, _y, __alcd_clockMonth);         /**< MM */
+        alcd_fbSet(_x + 5, _y, '/');
+        __alcd_clockDigits(_x + 6, _y, __alcd_clockYear / 100);    /**< YY.. */
+        __alcd_clockDigits(_x + 8, _y, __alcd_clockYear % 100);    /**< ..YY */
+    };
+
+    alcd_flush();                                                  /**< Send changed digits only */
+};
+#endif
+
+
+#ifdef __alcd_Modbus_Enable
+/* ============================================================================
+ *                       MODBUS RTU SLAVE
+ * ============================================================================ */
+#ifndef __alcd_Modbus_UART
+    #error "__alcd_Modbus_Enable requires __alcd_Modbus_UART (e.g. #define __alcd_Modbus_UART huart1)"
+#endif
+extern UART_HandleTypeDef __alcd_Modbus_UART;
+
+uint8_t __alcd_mbBuffer[__alcd_Modbus_BufferSize];  /**< DMA receive buffer, request is decoded and answered in place */
+volatile uint16_t __alcd_mbLength = 0;       /**< Length of the pending request, 0 = none */
+bool __alcd_mbAutoFlush = true;              /**< Flush after every write request */
+
+/* -------------------------------------------------------
+ * @brief Calculate Modbus CRC-16 (polynomial 0xA001, init 0xFFFF)
+ * @param _data: Pointer to data
+ * @param _length: Number of bytes
+ * @retval CRC value (low byte is transmitted first)
+ * ------------------------------------------------------- */
+static uint16_t __alcd_mbCRC(const uint8_t *_data, uint16_t _length)
+{
+    uint16_t _crc = 0xFFFF;                                        /**< CRC register */
+    uint8_t _bit = 0;                                              /**< Bit counter */
+
+    while(_length--)
+    {
+        _crc ^= *_data++;
+        for(_bit = 0; _bit < 8; _bit++)
+        {
+            _crc = (_crc & 0x0001) ? (_crc >> 1) ^ 0xA001 : (_crc >> 1);
+        };
+    };
+
+    return _crc;
+};
+
+/* -------------------------------------------------------
+ * @brief Read one holding register
+ * @param _register: Register address
+ * @param _value: Destination for register value
+ * @retval true if the register exists
+ * ------------------------------------------------------- */
+static bool __alcd_mbRead(uint16_t _register, uint16_t *_value)
+{
+    const uint8_t *_cells = &__alcd_fb[0][0];                      /**< Framebuffer as linear cell array */
+    uint16_t _index = 0;                                           /**< Register offset within its block */
+
+    if(_register < __alcd_Modbus_Cells + (__alcd_max_x * __alcd_max_y) / 2)
+    {
+        _index = (_register - __alcd_Modbus_Cells) * 2;
+        *_value = ((uint16_t)_cells[_index] << 8) | _cells[_index + 1];
+        return true;
+    };
+
+    if(_register >= __alcd_Modbus_CGRAM && _register < __alcd_Modbus_CGRAM + __alcd_CGRAM_Size / 2)
+    {
+        _index = (_register - __alcd_Modbus_CGRAM) * 2;
+        *_value = ((uint16_t)__alcd_vlcd.cgram[_index] << 8) | __alcd_vlcd.cgram[_index + 1];
+        return true;
+    };
+
+    switch(_register)
+    {
+        #ifdef __alcd_BL_GPIO_Port
+        case __alcd_Modbus_BackLight:
+            *_value = HAL_GPIO_ReadPin(__alcd_BL_GPIO_Port, __alcd_BL_Pin) == GPIO_PIN_SET;
+            return true;
+        #endif
+        case __alcd_Modbus_Display:
+            *_value = __alcd_vlcd.displayControl & 0x07;
+            return true;
+        case __alcd_Modbus_Flush:
+            *_value = __alcd_mbAutoFlush;
+            return true;
+        default:
+            return false;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Write one holding register
+ * @param _register: Register address (already validated)
+ * @param _value: Register value
+ * @param _glyphs: Working copy of CGRAM, modified by CGRAM registers
+ * @param _slots: Bit mask of modified glyph slots
+ * @retval None
+ * @note Cell registers go straight into the framebuffer; CGRAM changes
+ *       are collected and uploaded once per request
+ * ------------------------------------------------------- */
+static void __alcd_mbWrite(uint16_t _register, uint16_t _value, uint8_t *_glyphs, uint8_t *_slots)
+{
+    uint16_t _index = 0;                                           /**< Register offset within its block */
+
+    if(_register < __alcd_Modbus_Cells + (__alcd_max_x * __alcd_max_y) / 2)
+    {
+        _index = (_register - __alcd_Modbus_Cells) * 2;
+        alcd_fbSet(_index % __alcd_max_x, _index / __alcd_max_x, _value >> 8);
+        alcd_fbSet((_index + 1) % __alcd_max_x, (_index + 1) / __alcd_max_x, _value & 0xFF);
+        return;
+    };
+
+    if(_register >= __alcd_Modbus_CGRAM && _register < __alcd_Modbus_CGRAM + __alcd_CGRAM_Size / 2)
+    {
+        _index = (_register - __alcd_Modbus_CGRAM) * 2;
+        _glyphs[_index] = _value >> 8;
+        _glyphs[_index + 1] = _value & 0xFF;
+        bitSet(*_slots, _index >> 3);                              /**< Mark glyph for upload */
+        return;
+    };
+
+    switch(_register)
+    {
+        #ifdef __alcd_BL_GPIO_Port
+        case __alcd_Modbus_BackLight:
+            alcd_backLight(_value != 0);
+            break;
+        #endif
+        case __alcd_Modbus_Display:
+            alcd_display(bitCheck(_value, 2), bitCheck(_value, 1), bitCheck(_value, 0));
+            break;
+        case __alcd_Modbus_Flush:
+            __alcd_mbAutoFlush = bitCheck(_value, 0);
+            if(bitCheck(_value, 1))
+            {
+                alcd_flush();
+            };
+            break;
+        default:
+            break;
+    };
+};
+
+/* -------------------------------------------------------
+ * @brief Process one Modbus RTU request in place and build the response
+ * @param _frame: Request frame including CRC, overwritten by the response
+ * @param _length: Request length in bytes
+ * @retval Response length including CRC, 0 if no response must be sent
+ *         (bad CRC, other slave address or broadcast)
+ * @note Independent of the UART, so it can also serve requests that
+ *       arrive through another transport
+ * ------------------------------------------------------- */
+uint16_t alcd_modbusProcess(uint8_t *_frame, uint16_t _length)
+{
+    uint8_t _glyphs[__alcd_CGRAM_Size];                            /**< Working copy of CGRAM */
+    uint8_t _slots = 0;                                            /**< Glyph slots modified by this request */
+    uint16_t _start = 0, _count = 0, _value = 0, _index = 0;       /**< Request fields */
+    uint8_t _exception = 0;                                        /**< Exception code, 0 = success */
+    uint16_t _response = 0;                                        /**< Response length without CRC */
+    bool _write = false;                                           /**< Request modifies registers */
+
+    if(_length < 8 || __alcd_mbCRC(_frame, _length - 2) != (_frame[_length - 2] | (_frame[_length - 1] << 8)))
+    {
+        return 0;                                                  /**< Incomplete or corrupted frame: stay silent */
+    };
+    if(_frame[0] != __alcd_Modbus_Address && _frame[0] != 0)       /**< Not for this slave */
+    {
+        return 0;
+    };
+
+    _start = ((uint16_t)_frame[2] << 8) | _frame[3];
+    _count = ((uint16_t)_frame[4] << 8) | _frame[5];
+
+    switch(_frame[1])
+    {
+        case 0x03:                                                 /**< Read holding registers */
+            if(_count == 0 || _count > 125 || _length != 8)
+            {
+                _exception = 0x03;
+                break;
+            };
+            for(_index = 0; _index < _count && !_exception; _index++)
+            {
+                if(!__alcd_mbRead(_start + _index, &_value))
+                {
+                    _exception = 0x02;
+                    break;
+                };
+                _frame[3 + _index * 2] = _value >> 8;              /**< Response overwrites request in place */
+                _frame[4 + _index * 2] = _value & 0xFF;
+            };
+            _frame[2] = _count * 2;
+            _response = 3 + _count * 2;
+            break;
+
+        case 0x06:                                                 /**< Write single register */
+            if(_length != 8 || !__alcd_mbRead(_start, &_value))
+            {
+                _exception = (_length != 8) ? 0x03 : 0x02;
+                break;
+            };
+            _write = true;
+            memcpy(_glyphs, __alcd_vlcd.cgram, sizeof(_glyphs));
+            __alcd_mbWrite(_start, _count, _glyphs, &_slots);      /**< Value field sits where quantity would be */
+            _response = 6;                                         /**< Echo of the request */
+            break;
+
+        case 0x10:                                                 /**< Write multiple registers */
+            if(_count == 0 || _count > 123 || _frame[6] != _count * 2 || _length != 9 + _count * 2)
+            {
+                _exception = 0x03;
+                break;
+            };
+            for(_index = 0; _index < _count; _index++)             /**< Validate all addresses before writing */
+            {
+                if(!__alcd_mbRead(_start + _index, &_value))
+                {
+                    _exception = 0x02;
+                    break;
+                };
+            };
+            if(_exception)
+            {
+                break;
+            };
+            _write = true;
+            memcpy(_glyphs, __alcd_vlcd.cgram, sizeof(_glyphs));
+            for(_index = 0; _index < _count; _index++)             /**< Values taken straight from the receive buffer */
+            {
+                __alcd_mbWrite(_start + _index, ((uint16_t)_frame[7 + _index * 2] << 8) | _frame[8 + _index * 2], _glyphs, &_slots);
+            };
+            _response = 6;                                         /**< Address, function, start, quantity */
+            break;
+
+        default:
+            _exception = 0x01;                                     /**< Illegal function */
+            break;
+    };
+
+    if(_write)
+    {
+        for(_index = 0; _index < 8; _index++)                      /**< Upload modified glyphs once */
+        {
+            if(bitCheck(_slots, _index))
+            {
+                alcd_customChar(_index, &_glyphs[_index << 3]);
+            };
+        };
+        if(__alcd_mbAutoFlush)
+        {
+            alcd_flush();
+        };
+    };
+
+    if(_frame[0] == 0)                                             /**< Broadcast: never answered */
+    {
+        return 0;
+    };
+
+    if(_exception)
+    {
+        _frame[1] |= 0x80;
+        _frame[2] = _exception;
+        _response = 3;
+    };
+
+    _value = __alcd_mbCRC(_frame, _response);
+    _frame[_response++] = _value & 0xFF;                           /**< CRC low byte first */
+    _frame[_response++] = _value >> 8;
+
+    return _response;
+};
+
+/* -------------------------------------------------------
+ * @brief Start DMA reception of Modbus requests
+ * @retval None
+ * @note The UART must have a DMA RX channel and its interrupt enabled
+ *       (STM32CubeMX: USART1 DMA RX, USART1 global interrupt)
+ * ------------------------------------------------------- */
+void alcd_modbusStart(void)
+{
+    __alcd_mbLength = 0;
+    HAL_UARTEx_ReceiveToIdle_DMA(&__alcd_Modbus_UART, __alcd_mbBuffer, sizeof(__alcd_mbBuffer));
+    __HAL_DMA_DISABLE_IT(__alcd_Modbus_UART.hdmarx, DMA_IT_HT);   /**< Only idle line and buffer full end a frame */
+};
+
+/* -------------------------------------------------------
+ * @brief Signal a received frame
+ * @param _huart: UART handle passed to HAL_UARTEx_RxEventCallback()
+ * @param _size: Number of bytes received
+ * @retval None
+ * @note Call from HAL_UARTEx_RxEventCallback(). Only the length is
+ *       recorded here; decoding runs in alcd_modbusTask()
+ * ------------------------------------------------------- */
+void alcd_modbusRxEvent(UART_HandleTypeDef *_huart, uint16_t _size)
+{
+    if(_huart != &__alcd_Modbus_UART || HAL_UARTEx_GetRxEventType(_huart) == HAL_UART_RXEVENT_HT)
+    {
+        return;
+    };
+
+    __alcd_mbLength = _size;
+};
+
+/* -------------------------------------------------------
+ * @brief Process a pending Modbus request and send the response
+ * @retval None
+ * @note Call from the main loop. Reception restarts after the
+ *       response has been sent, as the master waits for it anyway.
+ *       The transmit timeout follows the response length and the
+ *       UART baud rate (a 255 byte response takes 266 ms at 9600)
+ * ------------------------------------------------------- */
+void alcd_modbusTask(void)
+{
+    uint16_t _length = __alcd_mbLength;                            /**< Length of pending request */
+    uint32_t _timeout = 0;                                         /**< Transmit timeout in ms */
+
+    if(_length == 0)
+    {
+        return;
+    };
+
+    _length = alcd_modbusProcess(__alcd_mbBuffer, _length);
+    if(_length)
+    {
+        _timeout = (uint32_t)_length * 11U * 1000U / __alcd_Modbus_UART.Init.BaudRate + __alcd_Modbus_TxMargin;  /**< 11 bits per character with parity */
+        HAL_UART_Transmit(&__alcd_Modbus_UART, __alcd_mbBuffer, _length, _timeout);
+    };
+
+    alcd_modbusStart();                                            /**< Ready for the next request */
+};
+#endif
+
+
+#ifdef __alcd_CAN_Enable
+/* ============================================================================
+ *                       CAN DISPLAY PROTOCOL
+ * ============================================================================ */
+uint8_t __alcd_canGlyph[8][8];               /**< Glyphs received, waiting for upload */
+volatile uint8_t __alcd_canGlyphPending = 0; /**< Bit mask of glyph slots waiting for upload */
+volatile int16_t __alcd_canPage = -1;        /**< Page selected by the master, -1 = none pending */
+
+/* -------------------------------------------------------
+ * @brief Decode a received display frame
+ * @param _id: Standard identifier of the frame
+ * @param _data: Frame data
+ * @param _length: Data length code (0-8)
+ * @retval true if the frame belongs to the display protocol
+ * @note Call from HAL_CAN_RxFifo0MsgPendingCallback() after
+ *       HAL_CAN_GetRxMessage(). Cells go straight into the framebuffer;
+ *       glyphs and page select are completed by alcd_canTask()
+ * ------------------------------------------------------- */
+bool alcd_canFrame(uint32_t _id, const uint8_t *_data, uint8_t _length)
+{
+    uint8_t _index = 0;                                            /**< Character/row counter */
+
+    if(_id < __alcd_CAN_BaseID)
+    {
+        return false;
+    };
+    _id -= __alcd_CAN_BaseID;
+
+    if(_id == __alcd_CAN_Cells && _length > 2)
+    {
+        if(_data[0] >= __alcd_max_y || _data[1] >= __alcd_max_x)   /**< Run starts off screen: drop the frame */
+        {
+            return true;
+        };
+        for(_index = 2; _index < _length && _data[1] + _index - 2 < __alcd_max_x; _index++)
+        {
+            alcd_fbSet(_data[1] + _index - 2, _data[0], _data[_index]); /**< Run stops at the row end */
+        };
+        return true;
+    };
+
+    if(_id == __alcd_CAN_Page && _length >= 1)
+    {
+        __alcd_canPage = _data[0];
+        return true;
+    };
+
+    if(_id >= __alcd_CAN_Glyph && _id < __alcd_CAN_Glyph + 8 && _length == 8)
+    {
+        _id -= __alcd_CAN_Glyph;
+        for(_index = 0; _index < 8; _index++)
+        {
+            __alcd_canGlyph[_id][_index] = _data[_index];
+        };
+        bitSet(__alcd_canGlyphPending, _id);
+        return true;
+    };
+
+    return false;
+};
+
+/* -------------------------------------------------------
+ * @brief Page select callback
+ * @param _page: Page number sent by the master
+ * @retval None
+ * @note Called from alcd_canTask() in main loop context. Default
+ *       implementation does nothing; override in the application.
+ * ------------------------------------------------------- */
+__weak void alcd_canPageCallback(uint8_t _page)
+{
+    UNUSED(_page);
+};
+
+/* -------------------------------------------------------
+ * @brief Upload received glyphs, handle page select and flush
+ * @retval None
+ * @note Call from the main loop. The bus is only driven here, never
+ *       from the CAN interrupt
+ * ------------------------------------------------------- */
+void alcd_canTask(void)
+{
+    uint8_t _slot = 0;                                             /**< Glyph slot counter */
+    uint8_t _rows[8];                                              /**< Glyph copied out of the receive buffer */
+    int16_t _page = -1;                                            /**< Pending page select */
+    uint32_t _primask = __get_PRIMASK();                           /**< Interrupt state on entry */
+
+    __disable_irq();                                               /**< Take the page select atomically */
+    _page = __alcd_canPage;
+    __alcd_canPage = -1;
+    __set_PRIMASK(_primask);
+
+    if(_page >= 0)
+    {
+        alcd_canPageCallback(_page);
+    };
 
+    for(_slot = 0; _slot < 8; _slot++)
+    {
+        if(bitCheck(__alcd_canGlyphPending, _slot))
+        {
+            _primask = __get_PRIMASK();
+            __disable_irq();                                       /**< Consistent copy against a new glyph frame */
+            memcpy(_rows, __alcd_canGlyph[_slot], sizeof(_rows));
+            bitClear(__alcd_canGlyphPending, _slot);
+            __set_PRIMASK(_primask);
+            alcd_customChar(_slot, _rows);
+        };
+    };
 
-/* ============================================================================
- *                      CUSTOM CHARACTER FUNCTIONS
- * ============================================================================ */
+    alcd_flush();
+};
 
 /* -------------------------------------------------------
- * @brief Create custom character in CGRAM
- * @param _alcd_CGRAMadd: CGRAM address (0-7) for custom character location
- * @param _alcd_CGRAMdata: Pointer to 8-byte array containing character pattern
- * @retval None
- * @note Each character is 5x8 pixels, represented by 8 bytes
- *       Each byte defines one row (5 LSBs used)
- *       After writing, cursor automatically returns to previous position
+ * @brief Build the next cell run frame for changed cells (master side)
+ * @param _remote: Copy of the slave's screen, updated with the frame
+ * @param _id: Destination for the frame identifier
+ * @param _data: Destination for the frame data (8 bytes)
+ * @retval Data length code, 0 when the slave is up to date
+ * @note The run starts at the first changed cell and spans up to
+ *       __alcd_CAN_RunMax cells of the same row, ending at the last
+ *       changed cell inside that window. Unchanged cells in between are
+ *       resent, which is cheaper than a new frame. Call repeatedly and
+ *       send each frame (HAL_CAN_AddTxMessage) until it returns 0.
+ *       Fill _remote with 0x00 to force a full screen transfer.
  * ------------------------------------------------------- */
-void alcd_customChar(uint8_t _alcd_CGRAMadd, const uint8_t *_alcd_CGRAMdata)
+uint8_t alcd_canEncode(uint8_t _remote[__alcd_max_y][__alcd_max_x], uint32_t *_id, uint8_t *_data)
 {
-    uint8_t _forCounter = 0;                                       /**< Loop counter for iterating through 8 character bytes */
-    
-    /* Calculate CGRAM address: base address + (character_index * 8) */
-    uint8_t _CG_Add = __alcd_CGRAM_Start + (_alcd_CGRAMadd << 3);  /**< Shift left by 3 equals multiply by 8 */
-    
-    /* Write all 8 bytes of character pattern to CGRAM */
-    for(_forCounter = 0; _forCounter < 8; _forCounter++)           /**< Loop through 8 rows of character pattern */
+    uint8_t _x = 0, _y = 0;                                        /**< Cell counters */
+    uint8_t _run = 0, _index = 0;                                  /**< Run length */
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
     {
-        alcd_write(_CG_Add++, __alcd_writeCmd);                    /**< Set CGRAM address for current row */
-        alcd_write(*_alcd_CGRAMdata++, __alcd_writeData);          /**< Write pattern data for current row */
+        for(_x = 0; _x < __alcd_max_x; _x++)
+        {
+            if(_remote[_y][_x] == __alcd_fb[_y][_x])
+            {
+                continue;
+            };
+
+            for(_index = 0; _index < __alcd_CAN_RunMax && _x + _index < __alcd_max_x; _index++)
+            {
+                if(_remote[_y][_x + _index] != __alcd_fb[_y][_x + _index])
+                {
+                    _run = _index + 1;                             /**< Extend run up to the last change */
+                };
+            };
+
+            *_id = __alcd_CAN_BaseID + __alcd_CAN_Cells;
+            _data[0] = _y;
+            _data[1] = _x;
+            for(_index = 0; _index < _run; _index++)
+            {
+                _data[2 + _index] = __alcd_fb[_y][_x + _index];
+                _remote[_y][_x + _index] = __alcd_fb[_y][_x + _index];
+            };
+            return _run + 2;
+        };
     };
-    
-    alcd_gotoxy(__alcd_x_position, __alcd_y_position);             /**< Restore cursor to position before CGRAM write */
+
+    return 0;
 };
+#endif
 
 
+#if defined(__alcd_Render_Enable) || defined(__alcd_Scroll_Enable)
 /* ============================================================================
- *                       BACKLIGHT CONTROL
+ *                       RENDERER (CGROM FONT)
  * ============================================================================ */
 
-#ifdef __alcd_BL_GPIO_Port
 /* -------------------------------------------------------
- * @brief Control LCD backlight state
- * @param _alcd_BL: Backlight state (true=ON/GPIO_PIN_SET, false=OFF/GPIO_PIN_RESET)
- * @retval None
- * @note Only available if __alcd_BL_GPIO_Port is defined in configuration
- *       Uses STM32 HAL GPIO function for direct pin control
+ * @brief CGROM font table for codes 0x20-0x7F
+ * @note 5 columns per character, bit 0 is the top pixel row
+ *       Codes 0x5C, 0x7E and 0x7F follow the A00 ROM; the A02
+ *       variants are substituted in alcd_renderGlyph()
  * ------------------------------------------------------- */
-void alcd_backLight(bool _alcd_BL)
+static const uint8_t __alcd_cgrom[96][__alcd_Glyph_Width] =
 {
-    HAL_GPIO_WritePin(__alcd_BL_GPIO_Port, __alcd_BL_Pin, _alcd_BL);  /**< Set backlight GPIO pin to requested state */
+    {0x00, 0x00, 0x00, 0x00, 0x00},   /**< 0x20 Space */
+    {0x00, 0x00, 0x5F, 0x00, 0x00},   /**< 0x21 '!' */
+    {0x00, 0x07, 0x00, 0x07, 0x00},   /**< 0x22 '"' */
+    {0x14, 0x7F, 0x14, 0x7F, 0x14},   /**< 0x23 '#' */
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12},   /**< 0x24 '$' */
+    {0x23, 0x13, 0x08, 0x64, 0x62},   /**< 0x25 '%' */
+    {0x36, 0x49, 0x55, 0x22, 0x50},   /**< 0x26 '&' */
+    {0x00, 0x05, 0x03, 0x00, 0x00},   /**< 0x27 '\'' */
+    {0x00, 0x1C, 0x22, 0x41, 0x00},   /**< 0x28 '(' */
+    {0x00, 0x41, 0x22, 0x1C, 0x00},   /**< 0x29 ')' */
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08},   /**< 0x2A '*' */
+    {0x08, 0x08, 0x3E, 0x08, 0x08},   /**< 0x2B '+' */
+    {0x00, 0x50, 0x30, 0x00, 0x00},   /**< 0x2C ',' */
+    {0x08, 0x08, 0x08, 0x08, 0x08},   /**< 0x2D '-' */
+    {0x00, 0x60, 0x60, 0x00, 0x00},   /**< 0x2E '.' */
+    {0x20, 0x10, 0x08, 0x04, 0x02},   /**< 0x2F '/' */
+    {0x3E, 0x51, 0x49, 0x45, 0x3E},   /**< 0x30 '0' */
+    {0x00, 0x42, 0x7F, 0x40, 0x00},   /**< 0x31 '1' */
+    {0x42, 0x61, 0x51, 0x49, 0x46},   /**< 0x32 '2' */
+    {0x21, 0x41, 0x45, 0x4B, 0x31},   /**< 0x33 '3' */
+    {0x18, 0x14, 0x12, 0x7F, 0x10},   /**< 0x34 '4' */
+    {0x27, 0x45, 0x45, 0x45, 0x39},   /**< 0x35 '5' */
+    {0x3C, 0x4A, 0x49, 0x49, 0x30},   /**< 0x36 '6' */
+    {0x01, 0x71, 0x09, 0x05, 0x03},   /**< 0x37 '7' */
+    {0x36, 0x49, 0x49, 0x49, 0x36},   /**< 0x38 '8' */
+    {0x06, 0x49, 0x49, 0x29, 0x1E},   /**< 0x39 '9' */
+    {0x00, 0x36, 0x36, 0x00, 0x00},   /**< 0x3A ':' */
+    {0x00, 0x56, 0x36, 0x00, 0x00},   /**< 0x3B ';' */
+    {0x08, 0x14, 0x22, 0x41, 0x00},   /**< 0x3C '<' */
+    {0x14, 0x14, 0x14, 0x14, 0x14},   /**< 0x3D '=' */
+    {0x00, 0x41, 0x22, 0x14, 0x08},   /**< 0x3E '>' */
+    {0x02, 0x01, 0x51, 0x09, 0x06},   /**< 0x3F '?' */
+    {0x32, 0x49, 0x79, 0x41, 0x3E},   /**< 0x40 '@' */
+    {0x7E, 0x11, 0x11, 0x11, 0x7E},   /**< 0x41 'A' */
+    {0x7F, 0x49, 0x49, 0x49, 0x36},   /**< 0x42 'B' */
+    {0x3E, 0x41, 0x41, 0x41, 0x22},   /**< 0x43 'C' */
+    {0x7F, 0x41, 0x41, 0x22, 0x1C},   /**< 0x44 'D' */
+    {0x7F, 0x49, 0x49, 0x49, 0x41},   /**< 0x45 'E' */
+    {0x7F, 0x09, 0x09, 0x09, 0x01},   /**< 0x46 'F' */
+    {0x3E, 0x41, 0x49, 0x49, 0x7A},   /**< 0x47 'G' */
+    {0x7F, 0x08, 0x08, 0x08, 0x7F},   /**< 0x48 'H' */
+    {0x00, 0x41, 0x7F, 0x41, 0x00},   /**< 0x49 'I' */
+    {0x20, 0x40, 0x41, 0x3F, 0x01},   /**< 0x4A 'J' */
+    {0x7F, 0x08, 0x14, 0x22, 0x41},   /**< 0x4B 'K' */
+    {0x7F, 0x40, 0x40, 0x40, 0x40},   /**< 0x4C 'L' */
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F},   /**< 0x4D 'M' */
+    {0x7F, 0x04, 0x08, 0x10, 0x7F},   /**< 0x4E 'N' */
+    {0x3E, 0x41, 0x41, 0x41, 0x3E},   /**< 0x4F 'O' */
+    {0x7F, 0x09, 0x09, 0x09, 0x06},   /**< 0x50 'P' */
+    {0x3E, 0x41, 0x51, 0x21, 0x5E},   /**< 0x51 'Q' */
+    {0x7F, 0x09, 0x19, 0x29, 0x46},   /**< 0x52 'R' */
+    {0x46, 0x49, 0x49, 0x49, 0x31},   /**< 0x53 'S' */
+    {0x01, 0x01, 0x7F, 0x01, 0x01},   /**< 0x54 'T' */
+    {0x3F, 0x40, 0x40, 0x40, 0x3F},   /**< 0x55 'U' */
+    {0x1F, 0x20, 0x40, 0x20, 0x1F},   /**< 0x56 'V' */
+    {0x3F, 0x40, 0x38, 0x40, 0x3F},   /**< 0x57 'W' */
+    {0x63, 0x14, 0x08, 0x14, 0x63},   /**< 0x58 'X' */
+    {0x07, 0x08, 0x70, 0x08, 0x07},   /**< 0x59 'Y' */
+    {0x61, 0x51, 0x49, 0x45, 0x43},   /**< 0x5A 'Z' */
+    {0x00, 0x7F, 0x41, 0x41, 0x00},   /**< 0x5B '[' */
+    {0x15, 0x16, 0x7C, 0x16, 0x15},   /**< 0x5C Yen sign (A00) */
+    {0x00, 0x41, 0x41, 0x7F, 0x00},   /**< 0x5D ']' */
+    {0x04, 0x02, 0x01, 0x02, 0x04},   /**< 0x5E '^' */
+    {0x40, 0x40, 0x40, 0x40, 0x40},   /**< 0x5F '_' */
+    {0x00, 0x01, 0x02, 0x04, 0x00},   /**< 0x60 '`' */
+    {0x20, 0x54, 0x54, 0x54, 0x78},   /**< 0x61 'a' */
+    {0x7F, 0x48, 0x44, 0x44, 0x38},   /**< 0x62 'b' */
+    {0x38, 0x44, 0x44, 0x44, 0x20},   /**< 0x63 'c' */
+    {0x38, 0x44, 0x44, 0x48, 0x7F},   /**< 0x64 'd' */
+    {0x38, 0x54, 0x54, 0x54, 0x18},   /**< 0x65 'e' */
+    {0x08, 0x7E, 0x09, 0x01, 0x02},   /**< 0x66 'f' */
+    {0x0C, 0x52, 0x52, 0x52, 0x3E},   /**< 0x67 'g' */
+    {0x7F, 0x08, 0x04, 0x04, 0x78},   /**< 0x68 'h' */
+    {0x00, 0x44, 0x7D, 0x40, 0x00},   /**< 0x69 'i' */
+    {0x20, 0x40, 0x44, 0x3D, 0x00},   /**< 0x6A 'j' */
+    {0x7F, 0x10, 0x28, 0x44, 0x00},   /**< 0x6B 'k' */
+    {0x00, 0x41, 0x7F, 0x40, 0x00},   /**< 0x6C 'l' */
+    {0x7C, 0x04, 0x18, 0x04, 0x78},   /**< 0x6D 'm' */
+    {0x7C, 0x08, 0x04, 0x04, 0x78},   /**< 0x6E 'n' */
+    {0x38, 0x44, 0x44, 0x44, 0x38},   /**< 0x6F 'o' */
+    {0x7C, 0x14, 0x14, 0x14, 0x08},   /**< 0x70 'p' */
+    {0x08, 0x14, 0x14, 0x18, 0x7C},   /**< 0x71 'q' */
+    {0x7C, 0x08, 0x04, 0x04, 0x08},   /**< 0x72 'r' */
+    {0x48, 0x54, 0x54, 0x54, 0x20},   /**< 0x73 's' */
+    {0x04, 0x3F, 0x44, 0x40, 0x20},   /**< 0x74 't' */
+    {0x3C, 0x40, 0x40, 0x20, 0x7C},   /**< 0x75 'u' */
+    {0x1C, 0x20, 0x40, 0x20, 0x1C},   /**< 0x76 'v' */
+    {0x3C, 0x40, 0x30, 0x40, 0x3C},   /**< 0x77 'w' */
+    {0x44, 0x28, 0x10, 0x28, 0x44},   /**< 0x78 'x' */
+    {0x0C, 0x50, 0x50, 0x50, 0x3C},   /**< 0x79 'y' */
+    {0x44, 0x64, 0x54, 0x4C, 0x44},   /**< 0x7A 'z' */
+    {0x00, 0x08, 0x36, 0x41, 0x00},   /**< 0x7B '{' */
+    {0x00, 0x00, 0x7F, 0x00, 0x00},   /**< 0x7C '|' */
+    {0x00, 0x41, 0x36, 0x08, 0x00},   /**< 0x7D '}' */
+    {0x08, 0x08, 0x2A, 0x1C, 0x08},   /**< 0x7E Right arrow (A00) */
+    {0x08, 0x1C, 0x2A, 0x08, 0x08}    /**< 0x7F Left arrow (A00) */
 };
 #endif
 
+#ifdef __alcd_Render_Enable
+/* -------------------------------------------------------
+ * @brief Render one character code into 8 glyph rows
+ * @param _alcd_frame: Controller mirror snapshot (source of CGRAM glyphs)
+ * @param _alcd_code: Character code as stored in DDRAM
+ * @param _alcd_rows: Destination for 8 rows (bit 4 = leftmost pixel)
+ * @retval None
+ * @note Codes 0x00-0x0F use CGRAM (0x08-0x0F mirror 0x00-0x07),
+ *       0x20-0x7F use the CGROM table, 0x10-0x1F and 0xA0 are blank,
+ *       0xFF is a full block and all other codes render hatched
+ * ------------------------------------------------------- */
+void alcd_renderGlyph(const alcd_vlcd_t *_alcd_frame, uint8_t _alcd_code, uint8_t *_alcd_rows)
+{
+    const uint8_t *_columns = NULL;                                /**< CGROM columns of the character */
+    uint8_t _row = 0;                                              /**< Glyph row counter */
+    uint8_t _column = 0;                                           /**< Glyph column counter */
 
-/* ============================================================================
- *                       DISPLAY CONTROL FUNCTIONS
- * ============================================================================ */
+    #ifdef __alcd_CGROM_A02
+        static const uint8_t _a02[3][__alcd_Glyph_Width] =         /**< A02 differs from A00 in these codes */
+        {
+            {0x02, 0x04, 0x08, 0x10, 0x20},                        /**< 0x5C '\\' */
+            {0x08, 0x04, 0x08, 0x10, 0x08},                        /**< 0x7E '~' */
+            {0x78, 0x46, 0x41, 0x46, 0x78},                        /**< 0x7F House */
+        };
+    #endif
+
+    memset(_alcd_rows, 0x00, __alcd_Glyph_Height);                 /**< Start from a blank glyph */
+
+    if(_alcd_code < 0x10)                                          /**< CGRAM character */
+    {
+        for(_row = 0; _row < __alcd_Glyph_Height; _row++)
+        {
+            _alcd_rows[_row] = _alcd_frame->cgram[((_alcd_code & 0x07) << 3) + _row] & 0x1F;
+        };
+        return;
+    };
+
+    if(_alcd_code < 0x20 || _alcd_code == 0xA0)                    /**< Blank codes */
+    {
+        return;
+    };
+
+    if(_alcd_code == 0xFF)                                         /**< Full block */
+    {
+        memset(_alcd_rows, 0x1F, __alcd_Glyph_Height - 1);
+        return;
+    };
+
+    if(_alcd_code >= 0x80)                                         /**< Not covered by the table */
+    {
+        for(_row = 0; _row < __alcd_Glyph_Height - 1; _row++)
+        {
+            _alcd_rows[_row] = (_row & 0x01) ? 0x0A : 0x15;        /**< Hatched placeholder */
+        };
+        return;
+    };
+
+    _columns = __alcd_cgrom[_alcd_code - 0x20];
+    #ifdef __alcd_CGROM_A02
+        if(_alcd_code == 0x5C) _columns = _a02[0];
+        if(_alcd_code == 0x7E) _columns = _a02[1];
+        if(_alcd_code == 0x7F) _columns = _a02[2];
+    #endif
+
+    /* Transpose column-major font data into CGRAM-style rows */
+    for(_column = 0; _column < __alcd_Glyph_Width; _column++)
+    {
+        for(_row = 0; _row < __alcd_Glyph_Height; _row++)
+        {
+            if(bitCheck(_columns[_column], _row))
+            {
+                bitSet(_alcd_rows[_row], (__alcd_Glyph_Width - 1) - _column);
+            };
+        };
+    };
+};
 
 /* -------------------------------------------------------
- * @brief Configure display, cursor, and blink settings
- * @param _alcd_Display: Display ON/OFF (true=visible, false=blank)
- * @param _alcd_Cursor: Cursor visibility ON/OFF (true=underline visible, false=hidden)
- * @param _alcd_Blink: Cursor blink ON/OFF (true=blinking block, false=steady)
+ * @brief Print the visible display as ASCII art via printf()
  * @retval None
- * @note All three settings can be configured independently
- *       Settings are combined into single command byte using bit manipulation
+ * @note Renders a snapshot of the mirror, so it reflects what the
+ *       controller shows (display shift included). Lit pixels are '#',
+ *       dark pixels '.', cells are separated by one space.
+ *       Output can be captured from the UART and compared against
+ *       golden screens.
  * ------------------------------------------------------- */
-void alcd_display(bool _alcd_Display, bool _alcd_Cursor, bool _alcd_Blink)
+void alcd_dump(void)
 {
-    /* Start with base display OFF command (0x08) */
-    uint8_t _cursorState = __alcd_Display_OFF;                     /**< Initialize with all features disabled */
-    
-    bitChange(_cursorState, 0, _alcd_Blink);                       /**< Set bit 0: cursor blink enable */
-    bitChange(_cursorState, 1, _alcd_Cursor);                      /**< Set bit 1: cursor visibility enable */
-    bitChange(_cursorState, 2, _alcd_Display);                     /**< Set bit 2: display ON/OFF */
-    
-    alcd_write(_cursorState, __alcd_writeCmd);                     /**< Send combined display control command to LCD */
+    alcd_vlcd_t _frame;                                            /**< Consistent copy of the mirror */
+    uint8_t _rows[__alcd_max_x][__alcd_Glyph_Height];              /**< Rendered glyphs of one display row */
+    uint8_t _x = 0, _y = 0, _row = 0, _pixel = 0;                  /**< Loop counters */
+
+    alcd_snapshot(&_frame);
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        for(_x = 0; _x < __alcd_max_x; _x++)                       /**< Render visible cells of this row */
+        {
+            alcd_renderGlyph(&_frame, _frame.ddram[_y][(_frame.shift + _x) % __alcd_DDRAM_Columns], _rows[_x]);
+        };
+
+        for(_row = 0; _row < __alcd_Glyph_Height; _row++)          /**< Print one pixel row across all cells */
+        {
+            for(_x = 0; _x < __alcd_max_x; _x++)
+            {
+                for(_pixel = 0; _pixel < __alcd_Glyph_Width; _pixel++)
+                {
+                    putchar(bitCheck(_rows[_x][_row], (__alcd_Glyph_Width - 1) - _pixel) ? '#' : '.');
+                };
+                putchar((_x < __alcd_max_x - 1) ? ' ' : '\n');
+            };
+        };
+        putchar('\n');                                            /**< Blank line between display rows */
+    };
 };
 
 /* -------------------------------------------------------
- * @brief Clear entire display and reset cursor to home
- * @retval None
- * @note This function performs two operations:
- *       1. Sends clear command to LCD hardware
- *       2. Resets internal position tracking to (0,0)
- *       Requires extended delay for clear operation to complete
+ * @brief Calculate a hash of the rendered visible display
+ * @retval 32-bit FNV-1a hash of all rendered glyph rows
+ * @note Two screens with identical pixels give identical hashes, even
+ *       when built from different character codes or CGRAM slots.
+ *       Useful for on-target comparison against golden screens.
  * ------------------------------------------------------- */
-void alcd_clear(void)
+uint32_t alcd_renderHash(void)
 {
-    alcd_write(__alcd_Display_Clear, __alcd_writeCmd);             /**< Send clear display command (0x01) */
-    __alcd_x_position = 0;                                         /**< Reset column position to start */
-    __alcd_y_position = 0;                                         /**< Reset row position to start */
-    __alcd_delay(__alcd_delay_modeSet);                            /**< Wait for clear operation (takes longer than normal commands) */
+    alcd_vlcd_t _frame;                                            /**< Consistent copy of the mirror */
+    uint8_t _rows[__alcd_Glyph_Height];                            /**< Rendered glyph */
+    uint32_t _hash = 0x811C9DC5;                                   /**< FNV-1a offset basis */
+    uint8_t _x = 0, _y = 0, _row = 0;                              /**< Loop counters */
+
+    alcd_snapshot(&_frame);
+
+    for(_y = 0; _y < __alcd_max_y; _y++)
+    {
+        for(_x = 0; _x < __alcd_max_x; _x++)
+        {
+            alcd_renderGlyph(&_frame, _frame.ddram[_y][(_frame.shift + _x) % __alcd_DDRAM_Columns], _rows);
+            for(_row = 0; _row < __alcd_Glyph_Height; _row++)
+            {
+                _hash = (_hash ^ _rows[_row]) * 0x01000193;        /**< FNV-1a prime */
+            };
+        };
+    };
+
+    return _hash;
 };
+#endif
 
 
+#ifdef __alcd_Scroll_Enable
 /* ============================================================================
- *                       CURSOR POSITIONING
+ *                       SMOOTH SCROLL
  * ============================================================================ */
+const char *__alcd_scrollText = NULL;        /**< Ticker text, NULL = stopped */
+uint16_t __alcd_scrollPixels = 0;            /**< Text width in pixel columns */
+uint16_t __alcd_scrollOffset = 0;            /**< Current step (pixel column offset) */
+uint8_t __alcd_scrollPos[2] = {0, 0};        /**< Window position (x, y) */
+uint8_t __alcd_scrollWidth = 0;              /**< Window width in cells */
 
 /* -------------------------------------------------------
- * @brief Move cursor to specific position on display
- * @param _alcd_x: Column position (0 to __alcd_max_x-1, typically 0-15)
- * @param _alcd_y: Row position (0 to __alcd_max_y-1, typically 0-1)
- * @retval None
- * @note Invalid positions (out of bounds) are clamped to (0,0)
- *       DDRAM addresses: Line 0 starts at 0x80, Line 1 starts at 0xC0
+ * @brief Get one pixel column of the ticker text
+ * @param _column: Pixel column, may lie outside the text
+ * @retval Column bits, bit 0 is the top pixel row
+ * @note Columns before and after the text and the gap column between
+ *       characters are blank; codes outside the table render blank
  * ------------------------------------------------------- */
-void alcd_gotoxy(uint8_t _alcd_x, uint8_t _alcd_y)
+static uint8_t __alcd_scrollColumn(int16_t _column)
 {
-    uint8_t _address = 0x00;                                       /**< Variable to hold calculated DDRAM address */
+    uint8_t _code = 0;                                             /**< Character under the column */
 
-    /* Validate position boundaries */
-    if(_alcd_x >= __alcd_max_x || _alcd_y >= __alcd_max_y)         /**< Check if position exceeds display dimensions */
-    {
-        __alcd_x_position = 0;                                     /**< Clamp to origin if invalid */
-        __alcd_y_position = 0;
-    }
-    else                                                           /**< Position is valid */
+    if(_column < 0 || _column >= __alcd_scrollPixels || (_column % __alcd_Scroll_Pitch) >= __alcd_Glyph_Width)
     {
-        __alcd_x_position = _alcd_x;                               /**< Update internal column tracker */
-        __alcd_y_position = _alcd_y;                               /**< Update internal row tracker */
+        return 0x00;
     };
 
-    /* Calculate DDRAM address based on row */
-    _address = (__alcd_y_position == 0) ? __alcd_Line1_Start : __alcd_Line2_Start;  /**< Select base address for row 0 or 1 */
-    _address = _address + __alcd_x_position;                       /**< Add column offset to base address */
+    _code = __alcd_scrollText[_column / __alcd_Scroll_Pitch];
+    if(_code < 0x20 || _code >= 0x80)
+    {
+        return 0x00;
+    };
 
-    alcd_write(_address, __alcd_writeCmd);                         /**< Send DDRAM address command (bit 7 already set in line start constants) */
+    return __alcd_cgrom[_code - 0x20][_column % __alcd_Scroll_Pitch];
 };
 
+/* -------------------------------------------------------
+ * @brief Start a pixel-smooth ticker in a window of CGRAM tiles
+ * @param _alcd_x: First column of the window
+ * @param _alcd_y: Row of the window
+ * @param _alcd_width: Window width in cells (1 to __alcd_Scroll_MaxWidth)
+ * @param _alcd_text: Text to scroll, must stay valid while the ticker runs
+ * @retval None
+ * @note Places custom characters 0..width-1 in the framebuffer; they
+ *       are sent with the next alcd_flush(). The text enters from the
+ *       right edge and the ticker repeats after it has left on the left.
+ * ------------------------------------------------------- */
+void alcd_scrollStart(uint8_t _alcd_x, uint8_t _alcd_y, uint8_t _alcd_width, const char *_alcd_text)
+{
+    uint8_t _tile = 0;                                             /**< Tile counter */
 
-/* ============================================================================
- *                       CHARACTER OUTPUT FUNCTIONS
- * ============================================================================ */
+    if(_alcd_width == 0 || _alcd_width > __alcd_Scroll_MaxWidth || _alcd_x + _alcd_width > __alcd_max_x || _alcd_y >= __alcd_max_y)
+    {
+        return;
+    };
+
+    __alcd_scrollText = _alcd_text;
+    __alcd_scrollPixels = strlen(_alcd_text) * __alcd_Scroll_Pitch;
+    __alcd_scrollOffset = 0;
+    __alcd_scrollPos[0] = _alcd_x;
+    __alcd_scrollPos[1] = _alcd_y;
+    __alcd_scrollWidth = _alcd_width;
+
+    for(_tile = 0; _tile < _alcd_width; _tile++)
+    {
+        alcd_fbSet(_alcd_x + _tile, _alcd_y, _tile);               /**< Cell shows its own CGRAM tile */
+    };
+};
 
 /* -------------------------------------------------------
- * @brief Print null-terminated string to LCD
- * @param _str: Pointer to null-terminated character string
- * @retval None
- * @note String is printed starting at current cursor position
- *       Each character advances cursor and may trigger auto-wrap
- *       Continues until '\0' terminator is encountered
+ * @brief Move the ticker by one pixel column
+ * @retval Number of CGRAM rows written
+ * @note Each tile row is compared with the mirrored CGRAM and only
+ *       changed rows are written; consecutive changed rows reuse the
+ *       auto-incremented address, so a row costs one or two bytes.
+ *       Call at the desired scroll speed (e.g. every 50 ms).
  * ------------------------------------------------------- */
-void alcd_puts(char* _str)
+uint8_t alcd_scrollStep(void)
 {
-    /* Iterate through string until null terminator */
-    while (*_str != '\0')                                          /**< Check for end of string */
+    uint8_t _tile = 0, _row = 0, _column = 0;                      /**< Loop counters */
+    uint8_t _bits = 0;                                             /**< New tile row */
+    uint8_t _address = 0;                                          /**< CGRAM address of the row */
+    uint8_t _written = 0;                                          /**< CGRAM rows written */
+    int16_t _first = 0;                                            /**< Text column at the left edge of the tile */
+
+    if(__alcd_scrollText == NULL)
     {
-        alcd_putc(*_str++);                                        /**< Print current character and advance pointer */
-    };  
+        return 0;
+    };
+
+    for(_tile = 0; _tile < __alcd_scrollWidth; _tile++)
+    {
+        _first = (int16_t)__alcd_scrollOffset + _tile * __alcd_Glyph_Width - __alcd_scrollWidth * __alcd_Glyph_Width;
+        for(_row = 0; _row < __alcd_Glyph_Height; _row++)
+        {
+            _bits = 0;
+            for(_column = 0; _column < __alcd_Glyph_Width; _column++)
+            {
+                if(bitCheck(__alcd_scrollColumn(_first + _column), _row))
+                {
+                    bitSet(_bits, (__alcd_Glyph_Width - 1) - _column);  /**< Bit 4 is the leftmost pixel */
+                };
+            };
+
+            _address = (_tile << 3) + _row;
+            if(__alcd_vlcd.cgram[_address] == _bits)               /**< Row unchanged: nothing to send */
+            {
+                continue;
+            };
+            if(!__alcd_vlcd.cgramSelect || __alcd_vlcd.address != _address)
+            {
+                alcd_write(__alcd_CGRAM_Start + _address, __alcd_writeCmd);
+            };
+            alcd_write(_bits, __alcd_writeData);
+            _written++;
+        };
+    };
+
+    if(_written)
+    {
+        __alcd_cursorMoved = true;                                 /**< Address counter left in CGRAM */
+    };
+
+    if(++__alcd_scrollOffset >= __alcd_scrollPixels + __alcd_scrollWidth * __alcd_Glyph_Width)
+    {
+        __alcd_scrollOffset = 0;                                   /**< Text has left the window: repeat */
+    };
+
+    return _written;
 };
 
 /* -------------------------------------------------------
- * @brief Print single character to LCD
- * @param _char: Character to print (ASCII value)
+ * @brief Stop the ticker and blank its window
  * @retval None
- * @note Character is printed at current cursor position
- *       Automatically wraps to next line when reaching end of current line
- *       Cursor position is tracked internally for proper wrapping
+ * @note The blank cells are sent with the next alcd_flush()
  * ------------------------------------------------------- */
-void alcd_putc(char _char)
+void alcd_scrollStop(void)
 {
-    alcd_write(_char, __alcd_writeData);                           /**< Send character data to LCD */
-    __alcd_x_position++;                                           /**< Advance to next column */
-    
-    /* Check for end of line condition */
-    if(__alcd_x_position >= __alcd_max_x)                          /**< If cursor reaches end of line */
+    uint8_t _tile = 0;                                             /**< Tile counter */
+
+    for(_tile = 0; _tile < __alcd_scrollWidth && __alcd_scrollText != NULL; _tile++)
     {
-        __alcd_x_position = 0;                                     /**< Reset to first column */
-        __alcd_y_position++;                                       /**< Move to next row */
-        alcd_gotoxy(__alcd_x_position, __alcd_y_position);         /**< Update cursor position on LCD */
+        alcd_fbSet(__alcd_scrollPos[0] + _tile, __alcd_scrollPos[1], ' ');
     };
+    __alcd_scrollText = NULL;
 };
+#endif
 
 
 /* ============================================================================
@@ -235,6 +3930,28 @@ void alcd_putc(char _char)
  * ------------------------------------------------------- */
 void alcd_write(uint8_t _data, bool _alcd_cmdData)
 {
+    #ifdef __alcd_Headless_Enable
+    if(!__alcd_present)                                            /**< Null transport */
+    {
+        #ifndef __alcd_Headless_NoShadow
+        __alcd_vlcdUpdate(_data, _alcd_cmdData);                   /**< Mirror still follows for UART/Modbus views */
+        #endif
+        return;
+    };
+    #endif
+
+    #ifdef __alcd_Stats_Enable
+        uint32_t _startCycles = DWT->CYCCNT;                       /**< Cycle counter at entry for blocking time */
+        __alcd_statsCount(commands, (_alcd_cmdData == __alcd_writeCmd));
+        __alcd_statsCount(data, (_alcd_cmdData == __alcd_writeData));
+    #endif
+
+    __alcd_vlcdUpdate(_data, _alcd_cmdData);                       /**< Keep controller mirror in sync */
+
+    #ifdef __alcd_Serial_Enable
+    __alcd_serialPut(_data, _alcd_cmdData);                        /**< Control byte and data into the I2C transaction */
+    #else
+
     /* Set command/data mode */
     HAL_GPIO_WritePin(__alcd_RS_GPIO_Port, __alcd_RS_Pin, _alcd_cmdData);  /**< RS=0 for command, RS=1 for data */
 
@@ -252,14 +3969,186 @@ void alcd_write(uint8_t _data, bool _alcd_cmdData)
     HAL_GPIO_WritePin(__alcd_EN_GPIO_Port, __alcd_EN_Pin, GPIO_PIN_SET);   /**< Enable high - start data latch */
     if(__alcd_initStatus == false)                                 /**< Check initialization status */
     {
-        __alcd_delay(__alcd_delay_modeSet);                        /**< Use longer delay during initialization (5ms) */
+        __alcd_wait(__alcd_delay_modeSet);                         /**< Use longer delay during initialization (5ms) */
     }
     else                                                           /**< Normal operation mode */
     {
-        __alcd_delay(__alcd_delay_CMD);                            /**< Use shorter delay for normal commands (50us) */
+        __alcd_wait(__alcd_delay_CMD);                             /**< Use shorter delay for normal commands (50us) */
     }
     HAL_GPIO_WritePin(__alcd_EN_GPIO_Port, __alcd_EN_Pin, GPIO_PIN_RESET); /**< Enable low - complete data latch */
+    __alcd_statsCount(enPulses, 1);                                /**< Count EN strobe */
+
+    #endif
+
+    __alcd_statsCount(busyCycles, DWT->CYCCNT - _startCycles);     /**< CPU time blocked in this write */
+};
+
+
+#ifdef __alcd_BusConfig_Enable
+/* ============================================================================
+ *                       BUS PIN CONFIGURATION
+ * ============================================================================ */
+typedef struct
+{
+    GPIO_TypeDef *port;                      /**< GPIO port */
+    uint32_t outputLow;                      /**< CRL image with data pins as outputs */
+    uint32_t outputHigh;                     /**< CRH image with data pins as outputs */
+    uint32_t inputLow;                       /**< CRL image with data pins as inputs */
+    uint32_t inputHigh;                      /**< CRH image with data pins as inputs */
+    uint16_t dataPins;                       /**< Data pins on this port */
+} alcd_busPort_t;
+
+alcd_busPort_t __alcd_busPorts[10];  /**< Register images, one entry per port used */
+uint8_t __alcd_busPortCount = 0;         /**< Valid entries in __alcd_busPorts */
+
+/* -------------------------------------------------------
+ * @brief Configure bus pins and precompute CRL/CRH images
+ * @retval None
+ * @note Enables the port clocks, takes the current CRL/CRH of each
+ *       involved port as the base and applies the output images
+ * ------------------------------------------------------- */
+static void __alcd_busSetup(void)
+{
+    GPIO_TypeDef *_ports[] = {__alcd_RS_GPIO_Port, __alcd_EN_GPIO_Port,  /**< Control pins first, then data pins */
+                              __alcd_DB0_GPIO_Port, __alcd_DB1_GPIO_Port, __alcd_DB2_GPIO_Port, __alcd_DB3_GPIO_Port,
+                              __alcd_DB4_GPIO_Port, __alcd_DB5_GPIO_Port, __alcd_DB6_GPIO_Port, __alcd_DB7_GPIO_Port};
+    const uint16_t _pins[] = {__alcd_RS_Pin, __alcd_EN_Pin,
+                              __alcd_DB0_Pin, __alcd_DB1_Pin, __alcd_DB2_Pin, __alcd_DB3_Pin,
+                              __alcd_DB4_Pin, __alcd_DB5_Pin, __alcd_DB6_Pin, __alcd_DB7_Pin};
+    alcd_busPort_t *_entry = NULL;                                 /**< Entry of the current port */
+    uint8_t _index = 0, _search = 0, _position = 0;                /**< Loop counters, pin number */
+    uint32_t _mask = 0;                                            /**< CNF/MODE nibble mask of the pin */
+
+    __alcd_busPortCount = 0;
+    for(_index = 0; _index < sizeof(_pins) / sizeof(_pins[0]); _index++)
+    {
+        for(_search = 0; _search < __alcd_busPortCount && __alcd_busPorts[_search].port != _ports[_index]; _search++);
+        _entry = &__alcd_busPorts[_search];
+        if(_search == __alcd_busPortCount)                         /**< First pin on this port */
+        {
+            RCC->APB2ENR |= RCC_APB2ENR_IOPAEN << (((uintptr_t)_ports[_index] - GPIOA_BASE) >> 10);  /**< Ports are 0x400 apart */
+            _entry->port = _ports[_index];
+            _entry->outputLow = _entry->inputLow = _ports[_index]->CRL;
+            _entry->outputHigh = _entry->inputHigh = _ports[_index]->CRH;
+            _entry->dataPins = 0;
+            __alcd_busPortCount++;
+        };
+
+        for(_position = 0; !bitCheck(_pins[_index], _position); _position++);  /**< Pin mask to pin number */
+        _mask = 0x0FUL << ((_position & 0x07) * 4);
+        if(_position < 8)
+        {
+            _entry->outputLow = (_entry->outputLow & ~_mask) | ((uint32_t)__alcd_Bus_Speed << ((_position & 0x07) * 4));
+            _entry->inputLow = (_entry->inputLow & ~_mask) | ((uint32_t)((_index >= 2) ? __alcd_Bus_CnfInput : __alcd_Bus_Speed) << ((_position & 0x07) * 4));
+        }
+        else
+        {
+            _entry->outputHigh = (_entry->outputHigh & ~_mask) | ((uint32_t)__alcd_Bus_Speed << ((_position & 0x07) * 4));
+            _entry->inputHigh = (_entry->inputHigh & ~_mask) | ((uint32_t)((_index >= 2) ? __alcd_Bus_CnfInput : __alcd_Bus_Speed) << ((_position & 0x07) * 4));
+        };
+        if(_index >= 2)
+        {
+            _entry->dataPins |= _pins[_index];
+        };
+    };
+
+    for(_index = 0; _index < __alcd_busPortCount; _index++)        /**< Start in write direction */
+    {
+        __alcd_busPorts[_index].port->CRL = __alcd_busPorts[_index].outputLow;
+        __alcd_busPorts[_index].port->CRH = __alcd_busPorts[_index].outputHigh;
+    };
+};
+
+#if defined(__alcd_Headless_Enable) && defined(__alcd_RW_GPIO_Port) && !defined(__alcd_Strap_GPIO_Port)
+/* -------------------------------------------------------
+ * @brief Switch the data pins between output and input
+ * @param _input: true=input with pull-down, false=push-pull output
+ * @retval None
+ * @note One CRL and one CRH store per port (plus BRR to select the
+ *       pull-down when switching to input)
+ * ------------------------------------------------------- */
+static void __alcd_busInput(bool _input)
+{
+    uint8_t _index = 0;                                            /**< Port counter */
+    alcd_busPort_t *_entry = NULL;                                 /**< Current port */
+
+    for(_index = 0; _index < __alcd_busPortCount; _index++)
+    {
+        _entry = &__alcd_busPorts[_index];
+        if(_input)
+        {
+            _entry->port->BRR = _entry->dataPins;                  /**< ODR=0 selects pull-down */
+        };
+        _entry->port->CRL = _input ? _entry->inputLow : _entry->outputLow;
+        _entry->port->CRH = _input ? _entry->inputHigh : _entry->outputHigh;
+    };
+};
+#endif
+#endif
+
+
+#if defined(__alcd_Headless_Enable) && defined(__alcd_RW_GPIO_Port) && !defined(__alcd_Strap_GPIO_Port)
+/* -------------------------------------------------------
+ * @brief Probe for a fitted display through the busy flag
+ * @retval true if a controller answered
+ * @note Sends a Clear command (1.52ms execution time) and reads DB7
+ *       with a pull-down while the controller must still be busy.
+ *       Without a display the pull-down reads 0. All data pins are
+ *       inputs while RW=1 so none of them drives against the
+ *       controller's outputs.
+ * ------------------------------------------------------- */
+static bool __alcd_probeBusy(void)
+{
+    #ifndef __alcd_BusConfig_Enable
+    GPIO_TypeDef *_ports[] = {__alcd_DB0_GPIO_Port, __alcd_DB1_GPIO_Port, __alcd_DB2_GPIO_Port, __alcd_DB3_GPIO_Port,
+                              __alcd_DB4_GPIO_Port, __alcd_DB5_GPIO_Port, __alcd_DB6_GPIO_Port, __alcd_DB7_GPIO_Port};
+    const uint16_t _pins[] = {__alcd_DB0_Pin, __alcd_DB1_Pin, __alcd_DB2_Pin, __alcd_DB3_Pin,
+                              __alcd_DB4_Pin, __alcd_DB5_Pin, __alcd_DB6_Pin, __alcd_DB7_Pin};
+    GPIO_InitTypeDef _pin = {0};                                   /**< Data pin configuration */
+    uint8_t _index = 0;                                            /**< Data pin counter */
+    #endif
+    GPIO_PinState _busy = GPIO_PIN_RESET;                          /**< Busy flag read back */
+
+    __alcd_initStatus = true;                                      /**< Short strobes, the read must fall in the busy time */
+    alcd_write(__alcd_Display_Clear, __alcd_writeCmd);
+    __alcd_initStatus = false;
+
+    #ifdef __alcd_BusConfig_Enable
+    __alcd_busInput(true);                                         /**< Release the data bus for the controller */
+    #else
+    _pin.Mode = GPIO_MODE_INPUT;
+    _pin.Pull = GPIO_PULLDOWN;
+    for(_index = 0; _index < sizeof(_pins) / sizeof(_pins[0]); _index++)
+    {
+        _pin.Pin = _pins[_index];
+        HAL_GPIO_Init(_ports[_index], &_pin);                      /**< Release every data pin before RW=1 */
+    };
+    #endif
+
+    HAL_GPIO_WritePin(__alcd_RS_GPIO_Port, __alcd_RS_Pin, GPIO_PIN_RESET);  /**< RS=0, RW=1: read busy flag */
+    HAL_GPIO_WritePin(__alcd_RW_GPIO_Port, __alcd_RW_Pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(__alcd_EN_GPIO_Port, __alcd_EN_Pin, GPIO_PIN_SET);
+    __alcd_delay(1);                                               /**< Data output delay (tDDR) */
+    _busy = HAL_GPIO_ReadPin(__alcd_DB7_GPIO_Port, __alcd_DB7_Pin);
+    HAL_GPIO_WritePin(__alcd_EN_GPIO_Port, __alcd_EN_Pin, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(__alcd_RW_GPIO_Port, __alcd_RW_Pin, GPIO_PIN_RESET);  /**< Back to write direction */
+
+    #ifdef __alcd_BusConfig_Enable
+    __alcd_busInput(false);                                        /**< Data bus output again */
+    #else
+    _pin.Mode = GPIO_MODE_OUTPUT_PP;
+    _pin.Pull = GPIO_NOPULL;
+    _pin.Speed = GPIO_SPEED_FREQ_LOW;
+    for(_index = 0; _index < sizeof(_pins) / sizeof(_pins[0]); _index++)
+    {
+        _pin.Pin = _pins[_index];
+        HAL_GPIO_Init(_ports[_index], &_pin);                      /**< Data pins output again */
+    };
+    #endif
+
+    return _busy == GPIO_PIN_SET;
 };
+#endif
 
 
 /* ============================================================================
@@ -286,28 +4175,56 @@ void alcd_write(uint8_t _data, bool _alcd_cmdData)
 void alcd_init(void)
 {
     __alcd_initStatus = false;                                     /**< Mark as not initialized - enables longer delays */
-    __alcd_delay(__alcd_delay_powerON);                            /**< Wait for LCD power stabilization (50ms) */
+    #ifdef __alcd_BusConfig_Enable
+    __alcd_busSetup();                                             /**< Own pin configuration and direction images */
+    #endif
+    #if defined(__alcd_Headless_Enable) && defined(__alcd_Strap_GPIO_Port)
+    __alcd_present = HAL_GPIO_ReadPin(__alcd_Strap_GPIO_Port, __alcd_Strap_Pin) == __alcd_Strap_Fitted;  /**< Strap decides before any delay */
+    #elif defined(__alcd_Headless_Enable)
+    __alcd_present = true;                                         /**< Assume fitted until the busy flag probe */
+    #endif
+    __alcd_wait(__alcd_delay_powerON);                             /**< Wait for LCD power stabilization (50ms) */
 
     /* Turn on backlight if available */
     #ifdef __alcd_BL_GPIO_Port
         HAL_GPIO_WritePin(__alcd_BL_GPIO_Port, __alcd_BL_Pin, GPIO_PIN_SET);  /**< Enable backlight at startup */
     #endif
 
+    #ifdef __alcd_Serial_Enable
+    __alcd_serialInit();                                           /**< Serial controller: own power-up sequence */
+    #else
     /* HD44780 initialization sequence for 8-bit mode */
     alcd_write(__alcd_Mode_8bit_2line_5x8, __alcd_writeCmd);       /**< Function set: 8-bit, 2 lines, 5x8 dots */
-    __alcd_delay(__alcd_delay_CMD);                                /**< Wait 100us for command to execute */
+    __alcd_wait(__alcd_delay_CMD);                                 /**< Wait 100us for command to execute */
+    #endif
     
+    #if defined(__alcd_Headless_Enable) && defined(__alcd_RW_GPIO_Port) && !defined(__alcd_Strap_GPIO_Port)
+    __alcd_present = __alcd_probeBusy();                           /**< Interface is set up: probe the busy flag */
+    __alcd_wait(__alcd_delay_modeSet);                             /**< Let the probe Clear finish */
+    #endif
+
     alcd_write(__alcd_Display_ON, __alcd_writeCmd);                /**< Display ON, cursor OFF, blink OFF */
-    __alcd_delay(__alcd_delay_modeSet);                            /**< Wait 5ms for command to execute */
+    __alcd_wait(__alcd_delay_modeSet);                             /**< Wait 5ms for command to execute */
     
     alcd_write(__alcd_Cursor_OFF, __alcd_writeCmd);                /**< Ensure cursor is OFF (redundant but ensures state) */
-    __alcd_delay(__alcd_delay_modeSet);                            /**< Wait 5ms for command to execute */
+    __alcd_wait(__alcd_delay_modeSet);                             /**< Wait 5ms for command to execute */
     
     alcd_write(__alcd_Entry_Inc, __alcd_writeCmd);                 /**< Entry mode: increment cursor, no display shift */
-    __alcd_delay(__alcd_delay_modeSet);                            /**< Wait 5ms for command to execute */
+    __alcd_wait(__alcd_delay_modeSet);                             /**< Wait 5ms for command to execute */
     
     alcd_write(__alcd_Display_Clear, __alcd_writeCmd);             /**< Clear display and reset cursor to home */
-    __alcd_delay(__alcd_delay_modeSet);                            /**< Wait 5ms for clear operation (takes longer) */
+    __alcd_wait(__alcd_delay_modeSet);                             /**< Wait 5ms for clear operation (takes longer) */
     
+    memset(__alcd_fb, ' ', sizeof(__alcd_fb));                     /**< Framebuffer matches cleared DDRAM */
+    __alcd_x_position = 0;                                         /**< Clear homed the cursor */
+    __alcd_y_position = 0;
+    __alcd_cursorMoved = false;
+    #ifdef __alcd_Lazy_Enable
+    __alcd_displayOn = true;                                       /**< Init switched the display on */
+    #endif
+    #ifdef __alcd_History_Enable
+    __alcd_historyStart();                                         /**< Continue the flash ring after reset */
+    #endif
+
     __alcd_initStatus = true;                                      /**< Mark as initialized - enables shorter delays */
 };
\ No newline at end of file
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""CAN display protocol tool for the aLCD slave and master (__alcd_CAN_Enable).
+
+Mirrors alcd_canEncode() and alcd_canFrame() and runs them against each
+other or against a target over Linux SocketCAN (can0, or vcan0 for a host
+build). Only the Python standard library is needed.
+
+    python3 alcd_can.py loopback --screens 1000
+    python3 alcd_can.py --iface can0 text 1 3 "AB.CD"
+    python3 alcd_can.py --iface can0 glyph 3 0 10 21 17 14 4 0 0
+    python3 alcd_can.py --iface can0 page 5
+    python3 alcd_can.py --iface can0 monitor
+
+"loopback" encodes random screen changes frame by frame, decodes every frame
+into a second screen and checks that both agree; it also feeds malformed cell
+frames (row or column off screen, runs past the row end) and checks that the
+decoder leaves the screen untouched outside the row. "text" sends the cell
+frames the master would send for a changed row segment, so a target slave can
+be driven without a master board; "monitor" decodes the frames a target master
+sends and prints the resulting screen after each one.
+"""
+import argparse
+import random
+import socket
+import struct
+import sys
+
+CELLS, PAGE, GLYPH = 0x00, 0x01, 0x10
+RUN_MAX = 6                                            # __alcd_CAN_RunMax
+FRAME = struct.Struct("=IB3x8s")                       # struct can_frame
+
+
+def encode(remote, screen):
+    """alcd_canEncode(): next cell run frame as (offset, data), None when up to date."""
+    for y, row in enumerate(screen):
+        for x in range(len(row)):
+            if remote[y][x] == row[x]:
+                continue
+            run = 0
+            for index in range(min(RUN_MAX, len(row) - x)):
+                if remote[y][x + index] != row[x + index]:
+                    run = index + 1
+            remote[y][x:x + run] = row[x:x + run]
+            return CELLS, bytes([y, x]) + bytes(row[x:x + run])
+    return None
+
+
+def decode(screen, glyphs, offset, data):
+    """alcd_canFrame(): apply one frame, returns (accepted, page or None)."""
+    if offset == CELLS and len(data) > 2:
+        y, x = data[0], data[1]
+        if y < len(screen) and x < len(screen[0]):
+            for index, value in enumerate(data[2:]):
+                if x + index >= len(screen[0]):
+                    break
+                screen[y][x + index] = value
+        return True, None
+    if offset == PAGE and len(data) >= 1:
+        return True, data[0]
+    if GLYPH <= offset < GLYPH + 8 and len(data) == 8:
+        glyphs[offset - GLYPH] = bytes(data)
+        return True, None
+    return False, None
+
+
+def loopback(args):
+    rng = random.Random(args.seed)
+    master = [[0x20] * args.cols for _ in range(args.rows)]
+    remote = [row[:] for row in master]
+    slave = [row[:] for row in master]
+    frames = 0
+    for _ in range(args.screens):
+        for _ in range(rng.randint(1, 8)):
+            y, x = rng.randrange(args.rows), rng.randrange(args.cols)
+            for index in range(rng.randint(1, 10)):
+                if x + index < args.cols:
+                    master[y][x + index] = rng.randrange(0x20, 0x7F)
+        while True:
+            frame = encode(remote, master)
+            if frame is None:
+                break
+            if not 3 <= len(frame[1]) <= 2 + RUN_MAX:
+                print("bad frame length %d" % len(frame[1]))
+                return 1
+            decode(slave, {}, *frame)
+            frames += 1
+        if slave != master:
+            print("screens differ after %d frames" % frames)
+            return 1
+
+    before = [row[:] for row in slave]
+    for data in (bytes([0, 0xFE]) + b"\x01" * 6,
+                 bytes([args.rows, 0]) + b"\x01" * 6,
+                 bytes([args.rows - 1, args.cols - 2]) + b"\x02" * 6):
+        decode(slave, {}, CELLS, data)
+    before[-1][-2:] = [2, 2]
+    if slave != before:
+        print("malformed frame changed the screen outside its row")
+        return 1
+    print("%d screens, %d frames, %.1f frames per screen: ok" % (args.screens, frames, frames / args.screens))
+    return 0
+
+
+def open_bus(args):
+    bus = socket.socket(socket.AF_CAN, socket.SOCK_RAW, socket.CAN_RAW)
+    bus.bind((args.iface,))
+    return bus
+
+
+def send(bus, args, offset, data):
+    bus.send(FRAME.pack(args.base + offset, len(data), bytes(data).ljust(8, b"\x00")))
+
+
+def monitor(bus, args):
+    screen = [[0x20] * args.cols for _ in range(args.rows)]
+    glyphs = {}
+    while True:
+        can_id, length, data = FRAME.unpack(bus.recv(FRAME.size))
+        offset = (can_id & socket.CAN_SFF_MASK) - args.base
+        accepted, page = decode(screen, glyphs, offset, data[:length])
+        if not accepted:
+            continue
+        if page is not None:
+            print("page %d" % page)
+        for row in screen:
+            print("|%s|" % "".join(chr(c) if 0x20 <= c < 0x7F else "." for c in row))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--iface", default="can0", help="SocketCAN interface")
+    parser.add_argument("--base", type=lambda v: int(v, 0), default=0x640, help="__alcd_CAN_BaseID")
+    parser.add_argument("--cols", type=int, default=16, help="__alcd_max_x")
+    parser.add_argument("--rows", type=int, default=2, help="__alcd_max_y")
+    parser.add_argument("--screens", type=int, default=1000, help="loopback: screen changes to run")
+    parser.add_argument("--seed", type=int, default=1, help="loopback: random seed")
+    parser.add_argument("command", choices=["loopback", "text", "glyph", "page", "monitor"])
+    parser.add_argument("values", nargs="*")
+    args = parser.parse_args()
+
+    if args.command == "loopback":
+        return loopback(args)
+    bus = open_bus(args)
+    if args.command == "text":
+        y, x, text = int(args.values[0]), int(args.values[1]), args.values[2].encode("ascii")
+        for start in range(0, len(text), RUN_MAX):
+            send(bus, args, CELLS, bytes([y, x + start]) + text[start:start + RUN_MAX])
+    elif args.command == "glyph":
+        send(bus, args, GLYPH + int(args.values[0]), [int(v, 0) for v in args.values[1:9]])
+    elif args.command == "page":
+        send(bus, args, PAGE, [int(args.values[0])])
+    else:
+        monitor(bus, args)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Capacity model of the aLCD transports.
+
+Runs workload profiles through a model of the driver and prints, for every
+transport, the bus time per update, the maximum update rate, and the bus
+utilization and CPU blocking at a given update rate:
+
+    python3 alcd_capacity.py --rate 10 --fields 4 --chars 5 --glyphs 2
+
+Transports:
+    gpio4   4-bit GPIO bus, two EN strobes of __alcd_delay_CMD per byte
+    gpio8   8-bit GPIO bus, one EN strobe per byte
+    i2cN    __alcd_Serial_Enable backend with I2C DMA at N kHz (100, 400)
+
+The byte sequences follow the driver: alcd_flush() sends one DDRAM address
+command per run of changed cells, alcd_customChar() writes address and
+pattern byte for each of the 8 rows and restores the cursor, and alcd_clear()
+waits __alcd_delay_modeSet after the Clear command (Return Home and init use
+the same wait). The serial backend sends a flush or glyph as one transaction
+of control/data pairs whose final run is compressed behind a single Co=0
+control byte, split at __alcd_Serial_BufferSize.
+
+All figures are computed from the driver delays and the bus clock; compare
+them with __alcd_stats (__alcd_Stats_Enable) measured on target. GPIO
+overhead is estimated as --gpio-cycles CPU cycles per HAL_GPIO_WritePin().
+"""
+import argparse
+
+CMD, DATA = 0, 1
+
+
+def flush(runs):
+    """alcd_flush(): one address command plus the cells of every run."""
+    sequence = []
+    for length in runs:
+        sequence.append(CMD)
+        sequence.extend([DATA] * length)
+    return sequence
+
+
+def glyph():
+    """alcd_customChar(): address and pattern byte per row, cursor restore."""
+    return [CMD, DATA] * 8 + [CMD]
+
+
+def workloads(args):
+    """Yield (name, [(transaction, clear waits)]) for every profile."""
+    full = [args.cols] * args.rows
+    yield "full refresh %dx%d" % (args.cols, args.rows), [(flush(full), 0)]
+    yield "clear + full refresh", [([CMD], 1), (flush(full), 0)]
+    yield "%d fields x %d chars" % (args.fields, args.chars), [(flush([args.chars] * args.fields), 0)]
+    yield "%d glyph animation" % args.glyphs, [(glyph(), 0)] * args.glyphs
+
+
+def serial_bytes(sequence, buffer_size):
+    """I2C payload bytes per transaction of the serial backend."""
+    transactions = []
+    pairs = buffer_size // 2
+    for start in range(0, len(sequence), pairs):
+        part = sequence[start:start + pairs]
+        run = 1
+        while run < len(part) and part[-run - 1] == part[-1]:
+            run += 1
+        transactions.append(2 * (len(part) - run) + 1 + run)    # pairs, Co=0 control, bare run
+    return transactions
+
+
+def cost(transport, updates, args):
+    """Bus time and CPU blocking in us for one update."""
+    bus = cpu = 0.0
+    nbytes = 0
+    for sequence, clears in updates:
+        wait = clears * args.clear_us
+        if transport.startswith("gpio"):
+            strobes = 2 if transport == "gpio4" else 1
+            pins = 1 + strobes * ((8 // strobes) + 2)               # RS, data pins and EN per strobe
+            per_byte = strobes * args.cmd_us + pins * args.gpio_cycles / args.clock
+            bus += len(sequence) * strobes * args.cmd_us + wait
+            cpu += len(sequence) * per_byte + wait
+            nbytes += len(sequence)
+        else:
+            khz = int(transport[3:])
+            for payload in serial_bytes(sequence, args.buffer):
+                bits = 9 * (payload + 1) + 2                        # address byte, ACKs, START/STOP
+                bus += bits * 1000.0 / khz
+                cpu += args.dma_us                                  # DMA does the transfer
+                nbytes += payload + 1
+            bus += wait
+            cpu += wait                                             # alcd_clear() busy-waits on every bus
+    return nbytes, bus, cpu
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cols", type=int, default=16, help="__alcd_max_x")
+    parser.add_argument("--rows", type=int, default=2, help="__alcd_max_y")
+    parser.add_argument("--cmd-us", type=float, default=50, help="__alcd_delay_CMD")
+    parser.add_argument("--clear-us", type=float, default=5000, help="__alcd_delay_modeSet")
+    parser.add_argument("--fields", type=int, default=4, help="changing fields per update")
+    parser.add_argument("--chars", type=int, default=5, help="characters per field")
+    parser.add_argument("--glyphs", type=int, default=2, help="CGRAM glyphs redefined per update")
+    parser.add_argument("--rate", type=float, default=10, help="update rate in Hz for utilization")
+    parser.add_argument("--clock", type=float, default=72, help="SystemCoreClock in MHz")
+    parser.add_argument("--gpio-cycles", type=float, default=12, help="cycles per HAL_GPIO_WritePin()")
+    parser.add_argument("--dma-us", type=float, default=5, help="CPU time to start one I2C DMA transfer")
+    parser.add_argument("--buffer", type=int, default=160, help="__alcd_Serial_BufferSize")
+    parser.add_argument("--transports", default="gpio4,gpio8,i2c100,i2c400")
+    args = parser.parse_args()
+
+    print("| Workload | Transport | Bytes | Bus time | Max rate | Bus @ %g Hz | CPU @ %g Hz |" % (args.rate, args.rate))
+    print("|----------|-----------|-------|----------|----------|-----------|-----------|")
+    for name, updates in workloads(args):
+        for transport in args.transports.split(","):
+            nbytes, bus, cpu = cost(transport, updates, args)
+            print("| %s | %s | %d | %.2f ms | %.0f Hz | %.1f %% | %.2f %% |" % (
+                name, transport, nbytes, bus / 1000, 1e6 / bus,
+                bus * args.rate / 1e4, cpu * args.rate / 1e4))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Compare aLCD screen captures against golden renderings.
+
+alcd_dump() (with __alcd_Render_Enable) prints the visible display as ASCII
+art through the CGROM font. Capture one dump per screen (printf retargeted
+to USART1), in the order of the golden files, then:
+
+    python3 alcd_golden.py capture.txt golden/demo.txt golden/rom_a00.txt
+
+Each golden file holds one dump; lines starting with ';' are comments, and
+the "; alcd_renderHash() 0x..." comment is the value alcd_renderHash()
+returns for that screen, for a check on target without a capture:
+
+    python3 alcd_golden.py --hash golden/demo.txt
+
+Differing cells are listed as (column, row); the exit status is the number
+of screens that differ.
+"""
+import argparse
+import re
+import sys
+
+PIXELS = re.compile(r"^[#.]{5}( [#.]{5})*$")
+HEIGHT = 8                                             # __alcd_Glyph_Height
+WIDTH = 5                                              # __alcd_Glyph_Width
+
+
+def pixel_lines(lines):
+    """Pixel rows of a dump, comments, blank lines and other output removed."""
+    return [line.rstrip("\n") for line in lines if PIXELS.match(line.rstrip("\n"))]
+
+
+def cells(lines):
+    """Glyph rows per cell: {(x, y): (row0, .. row7)} with bit 4 leftmost."""
+    result = {}
+    for y in range(len(lines) // HEIGHT):
+        rows = [lines[y * HEIGHT + r].split(" ") for r in range(HEIGHT)]
+        for x in range(len(rows[0])):
+            result[(x, y)] = tuple(int(rows[r][x].replace("#", "1").replace(".", "0"), 2)
+                                   for r in range(HEIGHT))
+    return result
+
+
+def render_hash(lines):
+    """FNV-1a over all glyph rows, in the order alcd_renderHash() uses."""
+    glyphs = cells(lines)
+    value = 0x811C9DC5
+    for x, y in sorted(glyphs, key=lambda cell: (cell[1], cell[0])):
+        for row in glyphs[(x, y)]:
+            value = ((value ^ row) * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--hash", action="store_true", help="print alcd_renderHash() of each file")
+    parser.add_argument("files", nargs="+", help="capture followed by golden files, or files to hash")
+    args = parser.parse_args()
+
+    if args.hash:
+        for name in args.files:
+            with open(name) as dump:
+                print("0x%08X  %s" % (render_hash(pixel_lines(dump)), name))
+        return 0
+
+    with open(args.files[0]) as dump:
+        capture = pixel_lines(dump)
+    failed = 0
+    for name in args.files[1:]:
+        with open(name) as dump:
+            golden = pixel_lines(dump)
+        screen, capture = capture[:len(golden)], capture[len(golden):]
+        if len(screen) < len(golden):
+            print("%s: capture ends early" % name)
+            failed += 1
+            continue
+        expected, actual = cells(golden), cells(screen)
+        wrong = sorted((cell for cell in expected if actual.get(cell) != expected[cell]),
+                       key=lambda cell: (cell[1], cell[0]))
+        if wrong:
+            print("%s: %d cells differ: %s" % (name, len(wrong), " ".join("(%d,%d)" % cell for cell in wrong)))
+            failed += 1
+        else:
+            print("%s: ok (0x%08X)" % (name, render_hash(screen)))
+    return failed
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Replay an aLCD display history dump as frames.
+
+Capture the output of alcd_historyDump() (printf retargeted to USART1) into
+a file, then:
+
+    python3 alcd_history.py dump.txt --cols 16 --rows 2
+
+Every record prints the screen as it looked after that flush, prefixed with
+its timestamp (HAL tick in ms unless alcd_historyTime() was overridden).
+'B' marks the first frame after a reset. Key frame sequence numbers
+continue across resets, so a gap means key frames were still queued in RAM
+when the board reset. Once the ring has wrapped, the dump starts at the
+oldest page still in flash, with a sequence number above 0. Records dropped
+because the queue was full take no sequence number and never show as a gap;
+they are counted only in the "# records .. dropped N" statistics line, which
+is passed through to stderr.
+"""
+import argparse
+import struct
+import sys
+
+
+def parse(lines):
+    """Yield the raw records of a dump, oldest first."""
+    for line in lines:
+        line = line.strip()
+        if line.startswith("H "):
+            yield bytes.fromhex(line[2:])
+        elif line.startswith("#"):
+            print(line, file=sys.stderr)
+
+
+def replay(records, cells):
+    """Yield (type, time, sequence, screen) after every record."""
+    screen = None
+    sequence = None
+    for record in records:
+        length, kind = record[0], chr(record[1])
+        time = struct.unpack_from("<I", record, 2)[0]
+        if kind in "KB":
+            sequence = struct.unpack_from("<I", record, 6)[0]
+            screen = bytearray(record[10:10 + cells])
+        elif kind == "D" and screen is not None:
+            index = 6
+            while index + 1 < length and record[index] != 0xFF:
+                position, count = record[index], record[index + 1]
+                screen[position:position + count] = record[index + 2:index + 2 + count]
+                index += 2 + count
+        else:
+            continue                                   # delta before the first key frame
+        yield kind, time, sequence, bytes(screen)
+
+
+def show(screen, cols):
+    text = "".join(chr(c) if 0x20 <= c < 0x7F else "." for c in screen)
+    return "\n".join("|" + text[i:i + cols] + "|" for i in range(0, len(text), cols))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    parser.add_argument("--cols", type=int, default=16, help="__alcd_max_x")
+    parser.add_argument("--rows", type=int, default=2, help="__alcd_max_y")
+    args = parser.parse_args()
+
+    last = None
+    for kind, time, sequence, screen in replay(parse(args.dump), args.cols * args.rows):
+        if kind in "KB" and last is not None and sequence != last + 1:
+            print("--- gap: key frames %d..%d missing ---" % (last + 1, sequence - 1))
+        if kind in "KB":
+            last = sequence
+        print("%10u %s%s" % (time, kind, " reset" if kind == "B" else ""))
+        print(show(screen, args.cols))
+
+
+if __name__ == "__main__":
+    main()
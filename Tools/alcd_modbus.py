@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Modbus RTU master for the aLCD display slave (__alcd_Modbus_Enable).
+
+Talks to the slave through any serial device: a USB-UART wired to USART1,
+or one end of a pty pair, e.g.
+
+    socat -d -d pty,raw,echo=0 pty,raw,echo=0
+
+whose other end feeds received frames to alcd_modbusProcess() and writes
+back the response. Only the Python standard library is needed.
+
+    python3 alcd_modbus.py --port /dev/ttyUSB0 text 0 0 "Hello Modbus"
+    python3 alcd_modbus.py --port /dev/ttyUSB0 read
+    python3 alcd_modbus.py --port /dev/ttyUSB0 glyph 2 0 10 21 17 14 4 0 0
+    python3 alcd_modbus.py --port /dev/ttyUSB0 backlight 1
+    python3 alcd_modbus.py --port /dev/ttyUSB0 display 1 0 0
+    python3 alcd_modbus.py --port /dev/ttyUSB0 flush
+    python3 alcd_modbus.py --port /dev/ttyUSB0 selftest
+
+"selftest" writes and reads back every cell, a glyph and the control
+registers, and checks the exception responses; it exits non-zero on the
+first mismatch.
+"""
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+CELLS, CGRAM, BACKLIGHT, DISPLAY, FLUSH = 0x0000, 0x0100, 0x0200, 0x0201, 0x0202
+BAUDS = {9600: termios.B9600, 19200: termios.B19200, 38400: termios.B38400,
+         57600: termios.B57600, 115200: termios.B115200}
+
+
+class ModbusError(Exception):
+    """Exception response from the slave."""
+
+    def __init__(self, function, code):
+        super().__init__("function 0x%02X exception %d" % (function, code))
+        self.code = code
+
+
+def crc16(frame):
+    crc = 0xFFFF
+    for byte in frame:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+class Master:
+    def __init__(self, port, baud, slave, timeout):
+        self.fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+        attrs = termios.tcgetattr(self.fd)
+        attrs[0] = attrs[1] = attrs[3] = 0                            # raw: no input, output or line processing
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[4] = attrs[5] = BAUDS[baud]
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        self.slave = slave
+        self.timeout = timeout
+        self.gap = max(0.002, 3.5 * 11 / baud)                        # 3.5 character times end a frame
+
+    def request(self, pdu):
+        frame = bytes([self.slave]) + pdu
+        termios.tcflush(self.fd, termios.TCIFLUSH)
+        os.write(self.fd, frame + struct.pack("<H", crc16(frame)))
+        if self.slave == 0:
+            return b""                                                # broadcast: no response
+        response = b""
+        deadline = time.monotonic() + self.timeout
+        while time.monotonic() < deadline:
+            ready, _, _ = select.select([self.fd], [], [], self.gap if response else self.timeout)
+            if not ready:
+                if response:
+                    break
+                continue
+            response += os.read(self.fd, 256)
+        if len(response) < 5 or crc16(response[:-2]) != struct.unpack("<H", response[-2:])[0]:
+            raise IOError("no valid response (%s)" % response.hex())
+        if response[0] != self.slave:
+            raise IOError("response from slave %d" % response[0])
+        if response[1] & 0x80:
+            raise ModbusError(response[1] & 0x7F, response[2])
+        return response[1:-2]
+
+    def read(self, address, count):
+        pdu = self.request(struct.pack(">BHH", 0x03, address, count))
+        return list(struct.unpack(">%dH" % count, pdu[2:2 + 2 * count]))
+
+    def write(self, address, value):
+        self.request(struct.pack(">BHH", 0x06, address, value))
+
+    def write_many(self, address, values):
+        self.request(struct.pack(">BHHB", 0x10, address, len(values), 2 * len(values))
+                     + struct.pack(">%dH" % len(values), *values))
+
+
+def cells_to_registers(data):
+    return [(data[i] << 8) | data[i + 1] for i in range(0, len(data), 2)]
+
+
+def registers_to_cells(registers):
+    return bytes(b for value in registers for b in (value >> 8, value & 0xFF))
+
+
+def write_text(master, args, column, row, text):
+    """Write text at a cell; odd start or end cells are read first."""
+    start = row * args.cols + column
+    first, last = start // 2, (start + len(text) - 1) // 2
+    cells = bytearray(registers_to_cells(master.read(CELLS + first, last - first + 1)))
+    cells[start - 2 * first:start - 2 * first + len(text)] = text
+    master.write_many(CELLS + first, cells_to_registers(cells))
+
+
+def read_screen(master, args):
+    cells = registers_to_cells(master.read(CELLS, args.cols * args.rows // 2))
+    return [cells[r * args.cols:(r + 1) * args.cols] for r in range(args.rows)]
+
+
+def selftest(master, args):
+    def check(name, condition):
+        print("%-32s %s" % (name, "ok" if condition else "FAILED"))
+        if not condition:
+            sys.exit(1)
+
+    pattern = bytes(0x20 + (i * 7) % 0x5F for i in range(args.cols * args.rows))
+    master.write_many(CELLS, cells_to_registers(pattern))
+    check("write/read all cells", b"".join(read_screen(master, args)) == pattern)
+    write_text(master, args, 3, 1, b"xyz")
+    check("odd aligned text", read_screen(master, args)[1][3:6] == b"xyz")
+    glyph = [0x00, 0x0A, 0x15, 0x11, 0x0E, 0x04, 0x00, 0x1F]
+    master.write_many(CGRAM + 4 * 3, cells_to_registers(glyph))
+    check("glyph slot 3", registers_to_cells(master.read(CGRAM + 4 * 3, 4)) == bytes(glyph))
+    master.write(DISPLAY, 0x04)
+    check("display control", master.read(DISPLAY, 1)[0] & 0x07 == 0x04)
+    master.write(FLUSH, 0x03)
+    check("flush", master.read(FLUSH, 1)[0] & 0x01 == 1)
+    for name, pdu, code in (("illegal function", struct.pack(">BHH", 0x2B, 0x0000, 1), 1),
+                            ("illegal address", struct.pack(">BHH", 0x03, 0x0300, 1), 2),
+                            ("illegal quantity", struct.pack(">BHH", 0x03, CELLS, 0), 3)):
+        try:
+            master.request(pdu)
+            check(name, False)
+        except ModbusError as error:
+            check(name, error.code == code)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", required=True, help="serial device or pty")
+    parser.add_argument("--baud", type=int, default=115200, choices=sorted(BAUDS))
+    parser.add_argument("--slave", type=int, default=1, help="__alcd_Modbus_Address, 0 = broadcast")
+    parser.add_argument("--cols", type=int, default=16, help="__alcd_max_x")
+    parser.add_argument("--rows", type=int, default=2, help="__alcd_max_y")
+    parser.add_argument("--timeout", type=float, default=0.5, help="response timeout in s")
+    parser.add_argument("command", choices=["text", "read", "glyph", "backlight", "display", "flush", "selftest"])
+    parser.add_argument("values", nargs="*")
+    args = parser.parse_args()
+    master = Master(args.port, args.baud, args.slave, args.timeout)
+
+    if args.command == "text":
+        write_text(master, args, int(args.values[1]), int(args.values[0]), args.values[2].encode("ascii"))
+    elif args.command == "read":
+        for row in read_screen(master, args):
+            print("|%s|" % "".join(chr(c) if 0x20 <= c < 0x7F else "." for c in row))
+    elif args.command == "glyph":
+        rows = [int(v, 0) for v in args.values[1:9]]
+        master.write_many(CGRAM + 4 * int(args.values[0]), cells_to_registers(rows))
+    elif args.command == "backlight":
+        master.write(BACKLIGHT, int(args.values[0]))
+    elif args.command == "display":
+        display, cursor, blink = (int(v) for v in args.values[:3])
+        master.write(DISPLAY, (display << 2) | (cursor << 1) | blink)
+    elif args.command == "flush":
+        master.write(FLUSH, 0x03)
+    else:
+        selftest(master, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Serial controller model for the aLCD I2C backend (__alcd_Serial_Enable).
+
+Replays captured transactions through a model of the ST7032, AIP31068 or
+US2066 and prints the screen and CGRAM the controller would show. A test
+transport prints every transaction as one "S" line of hex bytes,
+
+    S 80 80 C0 48 40 69
+
+for example through printf retargeted to USART1 on a board without a module,
+or from a host build; the example in API_Reference.md shows the function.
+Other lines are ignored, so the capture may contain any other output.
+
+    python3 alcd_serial.py capture.txt --controller st7032
+    python3 alcd_serial.py capture.txt --expect expected.txt
+
+Every control byte is checked: bits 5-0 must be 0, a Co=1 control byte
+must be followed by its data byte, and a Co=0 control byte starts the final
+run of the transaction. With --expect (one line of text per display row)
+the exit status is 1 when the screen differs.
+"""
+import argparse
+import re
+import sys
+
+LINE = re.compile(r"^S((?: [0-9A-Fa-f]{2})+)\s*$")
+CO, RS = 0x80, 0x40
+
+
+class Controller:
+    """HD44780 instruction set plus the extended modes that hide it."""
+
+    def __init__(self, kind, cols, rows):
+        self.kind, self.cols, self.rows = kind, cols, rows
+        self.ddram = [0x20] * 0x80
+        self.cgram = [0x00] * 64
+        self.ac, self.cg, self.increment = 0, False, True
+        self.extended = False                          # ST7032 IS=1, US2066 RE=1
+        self.oled = False                              # US2066 SD=1
+        self.parameter = False                         # US2066 data byte of 0x71/0x72
+        self.display = 0x00
+
+    def command(self, value):
+        if self.oled:                                  # US2066 OLED commands until SD=0
+            self.oled = value != 0x78
+            return
+        if 0x20 <= value < 0x40:                       # Function set switches the table in every mode
+            self.extended = bool(value & (0x01 if self.kind == "st7032" else 0x02)) and self.kind != "aip31068"
+            return
+        if self.extended and self.kind == "us2066":    # RE=1: only Clear and Return Home keep their meaning
+            self.oled = value == 0x79
+            self.parameter = value in (0x71, 0x72)
+            if value > 0x03:
+                return
+        if self.extended and self.kind == "st7032" and (0x10 <= value < 0x20 or 0x40 <= value < 0x80):
+            return                                     # IS=1: oscillator, contrast, power, follower
+        if value == 0x01:
+            self.ddram = [0x20] * 0x80
+            self.ac, self.cg, self.increment = 0, False, True
+        elif value & 0xFE == 0x02:
+            self.ac, self.cg = 0, False
+        elif value & 0xFC == 0x04:
+            self.increment = bool(value & 0x02)
+        elif value & 0xF8 == 0x08:
+            self.display = value & 0x07
+        elif value & 0x80:
+            self.ac, self.cg = value & 0x7F, False
+        elif value & 0x40:
+            self.ac, self.cg = value & 0x3F, True
+
+    def data(self, value):
+        if self.parameter:
+            self.parameter = False
+            return
+        step = 1 if self.increment else -1
+        if self.cg:
+            self.cgram[self.ac] = value
+            self.ac = (self.ac + step) & 0x3F
+        else:
+            self.ddram[self.ac] = value
+            line, column = self.ac & 0x40, (self.ac & 0x3F) + step
+            self.ac = line | (column % 40)
+
+    def screen(self):
+        offsets = [0x00, 0x40, self.cols, 0x40 + self.cols][:self.rows]
+        return ["".join(chr(c) if 0x20 <= c < 0x7F else "." for c in self.ddram[o:o + self.cols]) for o in offsets]
+
+
+def replay(controller, payload):
+    """Feed one transaction, returns an error string or None."""
+    index = 0
+    while index < len(payload):
+        control = payload[index]
+        index += 1
+        if control & 0x3F:
+            return "control byte 0x%02X has bits 5-0 set" % control
+        handler = controller.data if control & RS else controller.command
+        if control & CO:
+            if index == len(payload):
+                return "control byte 0x%02X without data byte" % control
+            handler(payload[index])
+            index += 1
+        else:
+            for value in payload[index:]:
+                handler(value)
+            return None
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="file with 'S <hex>' transaction lines")
+    parser.add_argument("--controller", default="st7032", choices=["st7032", "aip31068", "us2066"])
+    parser.add_argument("--cols", type=int, default=16, help="__alcd_max_x")
+    parser.add_argument("--rows", type=int, default=2, help="__alcd_max_y")
+    parser.add_argument("--expect", help="expected screen, one line per row")
+    args = parser.parse_args()
+
+    controller = Controller(args.controller, args.cols, args.rows)
+    transactions = nbytes = errors = 0
+    with open(args.capture) as capture:
+        for number, line in enumerate(capture, 1):
+            match = LINE.match(line)
+            if not match:
+                continue
+            payload = bytes.fromhex(match.group(1))
+            error = replay(controller, payload)
+            if error:
+                print("line %d: %s" % (number, error))
+                errors += 1
+            transactions += 1
+            nbytes += len(payload)
+
+    rows = controller.screen()
+    for row in rows:
+        print("|%s|" % row)
+    for slot in range(8):
+        pattern = controller.cgram[slot * 8:slot * 8 + 8]
+        if any(pattern):
+            print("CGRAM %d: %s" % (slot, " ".join("%02X" % value for value in pattern)))
+    print("# %d transactions, %d bytes, %d framing errors" % (transactions, nbytes, errors))
+
+    if args.expect:
+        with open(args.expect) as expect:
+            wanted = [line.rstrip("\n").ljust(args.cols)[:args.cols] for line in expect][:args.rows]
+        for y, (row, want) in enumerate(zip(rows, wanted)):
+            if row != want:
+                print("row %d differs: expected |%s|" % (y, want))
+                errors += 1
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())